@@ -12,7 +12,56 @@
 
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 #include "storage.h"
+#include "tuple_column.h"
+
+class BlockedBloomFilter;
+class SimpleHashFunction;
+
+/** Default number of tuples a TupleBatch can hold. */
+static const size_t DEFAULT_BATCH_SIZE = 1024;
+
+/**
+ * A fixed-capacity batch of tuples filled by AbstractExecutor::NextBatch().
+ * Tuple slots are allocated once and reused across batches, so refilling a
+ * batch reuses the storage of each slot (including the val2 string buffer).
+ */
+class TupleBatch {
+ public:
+  explicit TupleBatch(size_t capacity = DEFAULT_BATCH_SIZE)
+      : tuples_(capacity), size_(0) {}
+
+  /** @return the number of tuples currently in the batch */
+  size_t Size() const { return size_; }
+
+  /** @return the maximum number of tuples the batch can hold */
+  size_t Capacity() const { return tuples_.size(); }
+
+  bool IsEmpty() const { return size_ == 0; }
+  bool IsFull() const { return size_ == tuples_.size(); }
+
+  /** Drop all tuples, keeping the slots for reuse. */
+  void Clear() { size_ = 0; }
+
+  /**
+   * Slot the next tuple should be written to. It only becomes part of the
+   * batch after Commit() is called. Must not be called on a full batch.
+   */
+  Tuple *Slot() { return &tuples_[size_]; }
+
+  /** Append the tuple written into Slot() to the batch. */
+  void Commit() { ++size_; }
+
+  Tuple &operator[](size_t i) { return tuples_[i]; }
+  const Tuple &operator[](size_t i) const { return tuples_[i]; }
+
+ private:
+  std::vector<Tuple> tuples_;
+  size_t size_;
+};
 
 /**
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
@@ -41,4 +90,59 @@ class AbstractExecutor {
    * @return `true` if a tuple was produced, `false` if there are no more tuples
    */
   virtual bool Next(Tuple *tuple) = 0;
+
+  /**
+   * Yield up to batch->Capacity() tuples from this executor.
+   * The default implementation adapts Next(), so tuple-at-a-time executors
+   * keep working as children of batch executors. An executor should be
+   * driven either through Next() or through NextBatch(), not both.
+   * @param[out] batch cleared and then filled with the next tuples
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    while (!batch->IsFull() && Next(batch->Slot())) {
+      batch->Commit();
+    }
+    return !batch->IsEmpty();
+  }
+
+  /**
+   * Yield a read-only view of the next tuple instead of a copy.
+   * Scans override this to point straight into the table's storage, so
+   * read-only consumers never copy the val2 payload. The default
+   * implementation copies through Next() into a buffer owned by the executor.
+   * @param[out] tuple set to the next tuple; it stays valid until the next call
+   *             on this executor or until the underlying table is modified
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  virtual bool NextRef(const Tuple **tuple) {
+    if (!Next(&ref_tuple_)) return false;
+    *tuple = &ref_tuple_;
+    return true;
+  }
+
+  /**
+   * Ask this executor to drop tuples whose key hash is not in a Bloom filter
+   * before producing them. Scans support this; other executors ignore it.
+   * Must be called before Init(); pass NULL to remove a previous filter.
+   * @param filter the filter, which must outlive the use of this executor
+   * @param hash_fn the hash function the filter was built with
+   * @return `true` if the executor applies the filter
+   */
+  virtual bool PushDownBloomFilter(const BlockedBloomFilter * /*filter*/, SimpleHashFunction * /*hash_fn*/) {
+    return false;
+  }
+
+  /**
+   * Whether this executor produces its tuples in ascending order of a column,
+   * so consumers that need sorted input can skip sorting.
+   * @param column the column to check
+   * @return `true` if the output is sorted on column
+   */
+  virtual bool IsSortedOn(TupleColumn /*column*/) const { return false; }
+
+ private:
+  /** Buffer backing the default NextRef() implementation. */
+  Tuple ref_tuple_;
 };
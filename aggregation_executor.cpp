@@ -7,33 +7,30 @@ AggregationExecutor::AggregationExecutor(AbstractExecutor *child_executor,
 void AggregationExecutor::Init() { child_->Init(); }
 
 bool AggregationExecutor::Next(Tuple *tuple) {
-    int numberOfTuples = 0, totalSum = 0, maxValue1 = INT_MIN, minValue1 = INT_MAX;
-    while (child_->Next(tuple)) {
-        numberOfTuples++;
-        totalSum += tuple->val1;
-        maxValue1 = std::max(maxValue1, tuple->val1);
-        minValue1 = std::min(minValue1, tuple->val1);
+    AggregationState state;
+    // Only val1 is read, so the child's tuples are viewed in place instead of copied
+    const Tuple *childTuple;
+    while (child_->NextRef(&childTuple)) {
+        state.Update(childTuple->val1);
     }
-    if (numberOfTuples > 0) {
-        tuple->id = 0;
-        tuple->val2 = "";
-        switch (aggr_type_) {
-            case AggregationType::MIN:
-                tuple->val1 = minValue1;
-                break;
-            case AggregationType::SUM:
-                tuple->val1 = totalSum;
-                break;
-            case AggregationType::MAX:
-                tuple->val1 = maxValue1;
-                break;
-            case AggregationType::COUNT:
-                tuple->val1 = numberOfTuples;
-                break;
-            default:
-                break;
-        }
+    if (state.count > 0) {
+        FillAggregationResult(state, aggr_type_, tuple);
         return true;
     }
     return false;
 }
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    AggregationState state;
+    while (child_->NextBatch(&child_batch_)) {
+        for (size_t i = 0; i < child_batch_.Size(); i++) {
+            state.Update(child_batch_[i].val1);
+        }
+    }
+    if (state.count > 0) {
+        FillAggregationResult(state, aggr_type_, batch->Slot());
+        batch->Commit();
+    }
+    return !batch->IsEmpty();
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <vector>
 #include "abstract_executor.h"
 #include "storage.h"
@@ -33,6 +36,63 @@ enum class AggregationType {
   MAX
 };
 
+/**
+ * Running COUNT/SUM/MIN/MAX state over the "val1" attribute.
+ * COUNT and SUM use 64-bit accumulators so they do not overflow on large inputs.
+ * Partial states built over disjoint inputs can be combined with Merge().
+ */
+struct AggregationState {
+  AggregationState() : count(0), sum(0), max(INT_MIN), min(INT_MAX) {}
+
+  /** Add one "val1" value to the state. */
+  void Update(int value1) {
+    count++;
+    sum += value1;
+    max = std::max(max, value1);
+    min = std::min(min, value1);
+  }
+
+  /** Fold a partial state computed over a disjoint set of tuples into this one. */
+  void Merge(const AggregationState &other) {
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+    min = std::min(min, other.min);
+  }
+
+  /** @return the value of the given aggregation over the tuples seen so far */
+  int64_t Result(AggregationType aggr_type) const {
+    switch (aggr_type) {
+      case AggregationType::COUNT:
+        return count;
+      case AggregationType::SUM:
+        return sum;
+      case AggregationType::MIN:
+        return min;
+      case AggregationType::MAX:
+        return max;
+      default:
+        return 0;
+    }
+  }
+
+  int64_t count;  ///< Number of tuples aggregated.
+  int64_t sum;    ///< Sum of "val1".
+  int max;        ///< Largest "val1".
+  int min;        ///< Smallest "val1".
+};
+
+/**
+ * Write an aggregation result into a tuple: the result goes to "val1", "id" is 0
+ * and "val2" is empty. "val1" is an int, so a COUNT or SUM beyond its range is
+ * truncated; executors expose the full 64-bit value separately where needed.
+ */
+inline void FillAggregationResult(const AggregationState &state, AggregationType aggr_type, Tuple *tuple) {
+  tuple->id = 0;
+  tuple->val1 = (int)state.Result(aggr_type);
+  tuple->val2 = "";
+}
+
 /**
  * The AggregationExecutor class executes an aggregation operation (e.g., COUNT, SUM, MIN, MAX)
  * specifically on the "val1" attribute of the tuples from a child executor.
@@ -56,8 +116,16 @@ class AggregationExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple) override;
 
+  /**
+   * Yield the aggregation result as a batch, draining the child batch by batch.
+   * @param batch Filled with the single result tuple, or left empty if the child produced no tuples.
+   * @return `true` if a tuple was produced, `false` if there are no more tuples.
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
   AbstractExecutor *child_;          ///< Pointer to the child executor.
   std::vector<Tuple>::iterator iter_;///< Iterator to iterate over the tuples.
   AggregationType aggr_type_;        ///< The type of aggregation operation.
+  TupleBatch child_batch_;           ///< Buffer for batches pulled from the child executor.
 };
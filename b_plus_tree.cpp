@@ -1,7 +1,51 @@
 #include "../include/b_plus_tree.h"
+#include "../include/node_search.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
+/**
+ * Inserts an entry into the first count entries of a node array, shifting the rest up in place
+ * @param entries The node array, with room for count + 1 entries
+ * @param count The number of entries in use
+ * @param pos The position of the new entry
+ * @param entry The new entry
+ */
+template <typename T>
+static void insertEntryAt(T *entries, int count, int pos, const T &entry)
+{
+    memmove(entries + pos + 1, entries + pos, (count - pos) * sizeof(T));
+    entries[pos] = entry;
+}
+
+/**
+ * Copies entries [from, to) of the sequence src would be after inserting entry at pos,
+ * without building that sequence
+ * @param dst Receives to - from entries
+ * @param src The entries before the insert
+ * @param pos The position of the inserted entry
+ * @param entry The inserted entry
+ * @param from The first position of the sequence to copy
+ * @param to The end of the positions to copy
+ */
+template <typename T>
+static void copyEntriesWithInsert(T *dst, const T *src, int pos, const T &entry, int from, int to)
+{
+    int before = min(to, pos) - from;
+    if (before > 0) {
+        memcpy(dst, src + from, before * sizeof(T));
+        dst += before;
+    }
+    if (from <= pos && pos < to) {
+        *dst++ = entry;
+    }
+    int after = max(from, pos + 1);
+    if (to > after) {
+        memcpy(dst, src + after - 1, (to - after) * sizeof(T));
+    }
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  * Returns false if not empty
@@ -22,41 +66,17 @@ bool BPlusTree::IsEmpty() const
  */
 bool BPlusTree::GetValue(const KeyType &keyTp, RecordPointer &result)
 {
-    if (IsEmpty())
+    LeafNode *currentNode = findLeafNode(keyTp);
+    if (currentNode == NULL)
     {
         return false;
     }
-
-    Node *currentNode = root;
-
-
-    while (!currentNode->is_leaf)
-    {
-        for (int currIndex = 0; currIndex < currentNode->key_num; currIndex++)
-        {
-            if (keyTp < currentNode->keys[currIndex])
-            {
-                currentNode = ((InternalNode *)currentNode)->children[currIndex];
-                break;
-            }
-            if (currIndex == currentNode->key_num - 1)
-            {
-                currentNode = ((InternalNode *)currentNode)->children[currIndex + 1];
-                break;
-            }
-        }
-    }
-    for (int i = 0; i < currentNode->key_num; i++)
+    int i = NodeLowerBound(currentNode->keys, currentNode->key_num, keyTp);
+    if (i < currentNode->key_num && currentNode->keys[i] == keyTp)
     {
-        if (currentNode->keys[i] == keyTp)
-        {
-            result = ((LeafNode *)currentNode)->pointers[i];
-            // cout << "got the node\n";
-            return true;
-        }
+        result = currentNode->pointers[i];
+        return true;
     }
-    // cout << "did not get the node\n";
-
     return false;
 }
 
@@ -74,7 +94,7 @@ bool BPlusTree::Insert(const KeyType &key, const RecordPointer &value)
     if (IsEmpty())
     {
         // first key to be inserted
-        root = new LeafNode();
+        root = newLeafNode();
         root->key_num = 1;
         root->keys[0] = key;
         ((LeafNode *)root)->pointers[0] = value;
@@ -82,18 +102,20 @@ bool BPlusTree::Insert(const KeyType &key, const RecordPointer &value)
     }
     else
     {
-        Node *currNode = root;
-        Node *parent;
+        // Find the leaf node where the key should be inserted, remembering the way down
+        DescentPath path;
+        LeafNode *currNode = findLeafNode(key, &path);
 
-        // Find the leaf node where the key should be inserted
-        findLeafNodeToInsertNewKey(key, currNode, parent);
+        // We only support unique keys
+        int index = NodeLowerBound(currNode->keys, currNode->key_num, key);
+        if (index < currNode->key_num && currNode->keys[index] == key) return false;
 
         // If CurrNode has empty key slots
         // Insert it into this current node without any slice or rearranging
         if (currNode->key_num < MAX_FANOUT - 1) {
             return insertInCurrNodeAvlSlot(key, value, currNode);
         }
-        return insertInNewNodeAndRearrange(key, value, currNode, parent);
+        return insertInNewNodeAndRearrange(key, value, currNode, path);
     }
 }
 
@@ -101,52 +123,44 @@ bool BPlusTree::Insert(const KeyType &key, const RecordPointer &value)
  * Inserts a new Node in the tree and rearranges by adding new nodes in bottom up fashion
  * @param key The key to be inserted
  * @param value The pointer to the key points to in database
- * @param currNode The currentNode pointer
- * @param parent The Parent pointer
+ * @param currNode The full leaf node the key belongs to
+ * @param path The descent path from the root to currNode
  * @return true is successfully inserted else returns false
  */
-bool BPlusTree::insertInNewNodeAndRearrange(const int &key, const RecordPointer &value, Node *currNode, Node *parent) {
+bool BPlusTree::insertInNewNodeAndRearrange(const int &key, const RecordPointer &value, LeafNode *currNode, DescentPath &path) {
     try {
         // creating new leaf node
-        Node *newLeafNode = new LeafNode();
+        LeafNode *newLeaf = newLeafNode();
 
-        vector<int> vectorOfNodes(MAX_FANOUT);
-        vector<RecordPointer> vectorOfPointers(MAX_FANOUT);
+        // the full node and the new key make MAX_FANOUT entries, the lower half stays
+        int index = NodeLowerBound(currNode->keys, MAX_FANOUT - 1, key);
+        int leftCount = (MAX_FANOUT) / 2;
 
-        for (int index = 0; index < MAX_FANOUT - 1; index++)
-        {
-            vectorOfNodes[index] = currNode->keys[index];
-            vectorOfPointers[index] = ((LeafNode *)currNode)->pointers[index];
-        }
-        int index = 0, currentKey;
-        while (key > vectorOfNodes[index] && index < MAX_FANOUT - 1)
-            index++;
-        for (int keyCount = MAX_FANOUT - 1; keyCount > index; keyCount--)
-        {
-            vectorOfNodes[keyCount] = vectorOfNodes[keyCount - 1];
-            vectorOfPointers[keyCount] = vectorOfPointers[keyCount - 1];
-        }
-        vectorOfNodes[index] = key;
-        vectorOfPointers[index] = value;
-        currNode->key_num = (MAX_FANOUT) / 2;
-        newLeafNode->key_num = MAX_FANOUT - (MAX_FANOUT) / 2;
+        // filling newleaf node with the upper half, before the current node is rearranged
+        copyEntriesWithInsert(newLeaf->keys, currNode->keys, index, key, leftCount, MAX_FANOUT);
+        copyEntriesWithInsert(newLeaf->pointers, currNode->pointers, index, value, leftCount, MAX_FANOUT);
+        newLeaf->key_num = MAX_FANOUT - leftCount;
 
-        // filling cur leaf node again
-        for (index = 0; index < currNode->key_num; index++)
+        // the current node keeps its first entries, plus the new key if it belongs to the lower half
+        if (index < leftCount)
         {
-            currNode->keys[index] = vectorOfNodes[index];
-            ((LeafNode *)currNode)->pointers[index] = vectorOfPointers[index];
+            insertEntryAt(currNode->keys, leftCount - 1, index, key);
+            insertEntryAt(currNode->pointers, leftCount - 1, index, value);
         }
-        // filling newleaf node
-        for (index = 0, currentKey = currNode->key_num; index < newLeafNode->key_num; index++, currentKey++)
-        {
-            newLeafNode->keys[index] = vectorOfNodes[currentKey];
-            ((LeafNode *)newLeafNode)->pointers[index] = vectorOfPointers[currentKey];
+        currNode->key_num = leftCount;
+
+        // link the new leaf node right after the current one
+        newLeaf->next_leaf = currNode->next_leaf;
+        newLeaf->prev_leaf = currNode;
+        if (newLeaf->next_leaf != NULL) {
+            newLeaf->next_leaf->prev_leaf = newLeaf;
         }
-        if (currNode == root) {
-            return insertInRootNode(currNode, newLeafNode);
+        currNode->next_leaf = newLeaf;
+
+        if (path.empty()) {
+            return insertInRootNode(newLeaf->keys[0], currNode, newLeaf);
         }
-        return insertNodeInInternalTree(newLeafNode->keys[0], parent, newLeafNode);
+        return insertNodeInInternalTree(newLeaf->keys[0], path, newLeaf);
     }  catch (const std::exception& e) {
         std::cout<<"Exception occurred while inserting "<<e.what()<<endl;
         return false;
@@ -155,24 +169,22 @@ bool BPlusTree::insertInNewNodeAndRearrange(const int &key, const RecordPointer
 
 
 /**
- * Insert in the root node
- * @param currNode current node where the value must be inserted
- * @param newLeafNode the new Leaf node which must be added
+ * Grows the tree by one level with a new root over two nodes
+ * @param keyTp The separator key, the first key under newNode
+ * @param currNode The current root, which becomes the left child
+ * @param newNode The node split off the current root, which becomes the right child
  * @return True if successfully inserted and false if any error encountered
  */
-bool BPlusTree::insertInRootNode(Node *currNode, Node *newLeafNode) {
+bool BPlusTree::insertInRootNode(KeyType keyTp, Node *currNode, Node *newNode) {
     try {
-        Node *newRoot = new InternalNode();
+        Node *newRoot = newInternalNode();
         newRoot->key_num = 1;
-        newRoot->keys[0] = newLeafNode->keys[0];
+        newRoot->keys[0] = keyTp;
         ((InternalNode *)newRoot)->children[0] = currNode;
-        ((InternalNode *)newRoot)->children[1] = newLeafNode;
+        ((InternalNode *)newRoot)->children[1] = newNode;
 
         // Change the root of BPlusTree to new root with new value
         root = newRoot;
-        ((LeafNode *)currNode)->next_leaf = (LeafNode *)newLeafNode;
-        ((LeafNode *)newLeafNode)->prev_leaf = (LeafNode *)currNode;
-//        printNode(root, 0);
         return true;
     } catch (const std::exception& e) {
         std::cout<<"Exception occurred while inserting "<<e.what()<<endl;
@@ -187,19 +199,12 @@ bool BPlusTree::insertInRootNode(Node *currNode, Node *newLeafNode) {
  * @param currNode The current Node to insert the key
  * @return Return true if successfully inserted else returns false
  */
-bool BPlusTree::insertInCurrNodeAvlSlot(const int &key, const RecordPointer &value, Node *currNode) {
+bool BPlusTree::insertInCurrNodeAvlSlot(const int &key, const RecordPointer &value, LeafNode *currNode) {
     try {
-        int currIndex = 0;
-        for(; key > currNode->keys[currIndex] && currIndex < currNode->key_num; currIndex++) {};
-        for (int currentPointer = currNode->key_num; currentPointer > currIndex; currentPointer--)
-        {
-            currNode->keys[currentPointer] = currNode->keys[currentPointer - 1];
-            ((LeafNode *)currNode)->pointers[currentPointer] = ((LeafNode *)currNode)->pointers[currentPointer - 1];
-        }
-        currNode->keys[currIndex] = key;
-        ((LeafNode *)currNode)->pointers[currIndex] = value;
+        int currIndex = NodeLowerBound(currNode->keys, currNode->key_num, key);
+        insertEntryAt(currNode->keys, currNode->key_num, currIndex, (KeyType)key);
+        insertEntryAt(currNode->pointers, currNode->key_num, currIndex, value);
         currNode->key_num++;
-//        printNode(root, 0);
         return true;
     } catch (const std::exception& e) {
         std::cout<<"Exception occurred while inserting "<<e.what()<<endl;
@@ -209,46 +214,20 @@ bool BPlusTree::insertInCurrNodeAvlSlot(const int &key, const RecordPointer &val
 }
 
 /**
- * Search for the Leaf Node where the new value must be inserted
- * @param key The key to be inserted
- * @param currNode The node where value must be inserted
- * @param parent Parent of that pointer
- */
-void BPlusTree::findLeafNodeToInsertNewKey(const int &key, Node *&currNode, Node *&parent) {
-    while (!currNode->is_leaf)
-    {
-        // going to the leaf node where the key needs to be inserted
-        parent = currNode;
-        for (int index = 0; index < currNode->key_num; index++)
-        {
-            if (key < currNode->keys[index])
-            {
-                currNode = ((InternalNode *)currNode)->children[index];
-                break;
-            }
-            if (index == currNode->key_num - 1)
-            {
-                currNode = ((InternalNode *)currNode)->children[index + 1];
-                break;
-            }
-        }
-    }
-}
-
-/**
- * Inserts a node in Internal part of the Tree
- * @param keyTp The key to insert
- * @param parentNode The parentNode
+ * Inserts a node in Internal part of the Tree, next to the child the descent path went through
+ * @param keyTp The key to insert, the first key under childNode
+ * @param path The descent path, its last entry is the parent of childNode
  * @param childNode The childNode
  * @return Return true if successfully inserted else returns false
  */
-bool BPlusTree::insertNodeInInternalTree(KeyType keyTp, Node *parentNode, Node *childNode)
+bool BPlusTree::insertNodeInInternalTree(KeyType keyTp, DescentPath &path, Node *childNode)
 {
     try {
+        InternalNode *parentNode = path.back().node;
         if (parentNode->key_num < MAX_FANOUT - 1) {
-            return insertKeyInParentAvlSlot(keyTp, parentNode, childNode);
+            return insertKeyInParentAvlSlot(keyTp, parentNode, path.back().child_index, childNode);
         }
-        return insertInTreeByCreatingNewNode(keyTp, parentNode, childNode);
+        return insertInTreeByCreatingNewNode(keyTp, path, childNode);
     } catch (const std::exception& e) {
         std::cout<<"Error in insertNodeInInternalTree "<<e.what()<<endl;
         return false;
@@ -258,78 +237,45 @@ bool BPlusTree::insertNodeInInternalTree(KeyType keyTp, Node *parentNode, Node *
 
 
 /**
- * Creates and Inserts a new Node in Internal part of the Tree
+ * Splits a full internal node to insert a new child, and pushes the middle key to its parent
  * @param keyTp The key to insert
- * @param parentNode The parentNode
+ * @param path The descent path, its last entry is the full node
  * @param childNode The childNode
  * @return Return true if successfully inserted else returns false
  */
-bool BPlusTree::insertInTreeByCreatingNewNode(int keyTp, Node *parentNode, Node *childNode) {
+bool BPlusTree::insertInTreeByCreatingNewNode(int keyTp, DescentPath &path, Node *childNode) {
     try {
-        Node *newIntNode = new InternalNode();
-        vector<int> vectorOfKeys(MAX_FANOUT);
-        vector<Node *> vtrOfChildPointers(MAX_FANOUT + 1);
-        for (int index = 0; index < MAX_FANOUT - 1; index++)
+        InternalNode *parentNode = path.back().node;
+        int index = path.back().child_index;
+        path.pop_back();
+
+        InternalNode *newIntNode = newInternalNode();
+
+        // the full node and the new key make MAX_FANOUT keys: the lower half stays,
+        // the key after it moves up and the rest goes to the new node
+        int leftKeys = (MAX_FANOUT) / 2;
+        KeyType middleKey = leftKeys < index ? parentNode->keys[leftKeys]
+                          : leftKeys == index ? keyTp
+                                              : parentNode->keys[leftKeys - 1];
+        // the new child goes right after the child the descent went through
+        copyEntriesWithInsert(newIntNode->keys, parentNode->keys, index, (KeyType)keyTp, leftKeys + 1, MAX_FANOUT);
+        copyEntriesWithInsert(newIntNode->children, parentNode->children, index + 1, childNode, leftKeys + 1, MAX_FANOUT + 1);
+        newIntNode->key_num = MAX_FANOUT - 1 - leftKeys;
+
+        // refill the parent node, the new key may have landed in its half
+        if (index < leftKeys)
         {
-            vectorOfKeys[index] = parentNode->keys[index];
-        }
-        for (int index = 0; index < MAX_FANOUT; index++)
-        {
-            vtrOfChildPointers[index] = ((InternalNode *)parentNode)->children[index];
-        }
-        int index = 0, j;
-        while (keyTp > vectorOfKeys[index] && index < MAX_FANOUT - 1)
-            index++;
-        for (int childIndex = MAX_FANOUT - 1; childIndex > index; childIndex--)
-        {
-            vectorOfKeys[childIndex] = vectorOfKeys[childIndex - 1];
-        }
-        vectorOfKeys[index] = keyTp;
-        for (int childIndex = MAX_FANOUT; childIndex > index + 1; childIndex--)
-        {
-            vtrOfChildPointers[childIndex] = vtrOfChildPointers[childIndex - 1];
-        }
-        vtrOfChildPointers[index + 1] = childNode;
-        
-        if (childNode->is_leaf)
-        {
-            ((LeafNode *)childNode)->next_leaf = ((LeafNode *)(vtrOfChildPointers[index]))->next_leaf;
-            ((LeafNode *)(vtrOfChildPointers[index]))->next_leaf = (LeafNode *)childNode;
-            ((LeafNode *)childNode)->prev_leaf = ((LeafNode *)(vtrOfChildPointers[index]));
-            if (((LeafNode *)childNode)->next_leaf != NULL)
-            {
-                ((LeafNode *)childNode)->next_leaf->prev_leaf = (LeafNode *)childNode;
-            }
-        }
-
-        parentNode->key_num = (MAX_FANOUT) / 2;
-        newIntNode->key_num = MAX_FANOUT - 1 - (MAX_FANOUT) / 2;
-        for (index = 0, j = parentNode->key_num + 1; index < newIntNode->key_num; index++, j++)
-        {
-            newIntNode->keys[index] = vectorOfKeys[j];
-        }
-        for (index = 0, j = parentNode->key_num + 1; index < newIntNode->key_num + 1; index++, j++)
-        {
-            ((InternalNode *)newIntNode)->children[index] = vtrOfChildPointers[j];
+            insertEntryAt(parentNode->keys, leftKeys - 1, index, (KeyType)keyTp);
+            insertEntryAt(parentNode->children, leftKeys, index + 1, childNode);
         }
+        parentNode->key_num = leftKeys;
 
-        if (parentNode == root)
+        // the middle key moves up to the grandparent
+        if (path.empty())
         {
-            Node *newRoot = new InternalNode();
-            newRoot->keys[0] = parentNode->keys[parentNode->key_num];
-            ((InternalNode *)newRoot)->children[0] = parentNode;
-            ((InternalNode *)newRoot)->children[1] = newIntNode;
-            newRoot->key_num = 1;
-            root = newRoot;
-            return true;
-        }
-        else
-        {
-            // changed 1st argument from parentNode->keys[parentNode->key_num] for 222
-            return insertNodeInInternalTree(vectorOfKeys[parentNode->key_num],
-                                            parentNodeSearch(root, parentNode),
-                                            newIntNode);
+            return insertInRootNode(middleKey, parentNode, newIntNode);
         }
+        return insertNodeInInternalTree(middleKey, path, newIntNode);
     } catch (exception& e) {
         cout<<"Error in insertInTreeByCreatingNewNode "<<e.what()<<endl;
         return false;
@@ -341,34 +287,15 @@ bool BPlusTree::insertInTreeByCreatingNewNode(int keyTp, Node *parentNode, Node
  * Creates and Inserts a new Key in available parent key slot
  * @param keyTp The key to insert
  * @param parentNode The parentNode
+ * @param childIndex The position of the child the new node was split off
  * @param childNode The childNode
  * @return Return true if successfully inserted else returns false
  */
-bool BPlusTree::insertKeyInParentAvlSlot(int keyTp, Node *parentNode, Node *childNode) {
+bool BPlusTree::insertKeyInParentAvlSlot(int keyTp, InternalNode *parentNode, int childIndex, Node *childNode) {
     try {
-        int childIndex = 0;
-        while (keyTp > parentNode->keys[childIndex] && childIndex < parentNode->key_num)
-            childIndex++;
-        for (int j = parentNode->key_num; j > childIndex; j--)
-        {
-            parentNode->keys[j] = parentNode->keys[j - 1];
-        }
-        for (int j = parentNode->key_num + 1; j > childIndex + 1; j--)
-        {
-            ((InternalNode *)parentNode)->children[j] = ((InternalNode *)parentNode)->children[j - 1];
-        }
-        parentNode->keys[childIndex] = keyTp;
+        insertEntryAt(parentNode->keys, parentNode->key_num, childIndex, (KeyType)keyTp);
+        insertEntryAt(parentNode->children, parentNode->key_num + 1, childIndex + 1, childNode);
         parentNode->key_num++;
-        ((InternalNode *)parentNode)->children[childIndex + 1] = childNode;
-
-        if (childNode->is_leaf) {
-            ((LeafNode *)childNode)->next_leaf = ((LeafNode *)(((InternalNode *)parentNode)->children[childIndex]))->next_leaf;
-            ((LeafNode *)(((InternalNode *)parentNode)->children[childIndex]))->next_leaf = (LeafNode *)childNode;
-            ((LeafNode *)childNode)->prev_leaf = (LeafNode *)(((InternalNode *)parentNode)->children[childIndex]);
-            if (((LeafNode *)childNode)->next_leaf) {
-                ((LeafNode *)childNode)->next_leaf->prev_leaf = (LeafNode *)childNode;
-            }
-        }
         return true;
     } catch (std::exception& e) {
         std::cout<<"Error occurred in insertKeyInParentAvlSlot "<<e.what()<<endl;
@@ -377,32 +304,13 @@ bool BPlusTree::insertKeyInParentAvlSlot(int keyTp, Node *parentNode, Node *chil
 
 }
 
-
-/**
- * Finds the parent Node and returns it
- * @param currentNode The current Node
- * @param childNode The child Node
- * @return Returns the parent node if found else returns NULL
- */
-Node *BPlusTree::parentNodeSearch(Node *currentNode, Node *childNode)
-{
-    if (currentNode->is_leaf || (((InternalNode *)currentNode)->children[0])->is_leaf) {
-        return NULL;
-    }
-    for (int currNodeIndex = 0; currNodeIndex < currentNode->key_num + 1; currNodeIndex++) {
-        if (((InternalNode *)currentNode)->children[currNodeIndex] == childNode) {
-            return currentNode;
-        } else {
-            Node *parent = parentNodeSearch(((InternalNode *) currentNode)->children[currNodeIndex], childNode);
-            if (parent) return parent;
-        }
-    }
-    return NULL;
-}
-
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
+// Fewest keys a non-root node may hold before it borrows from or merges with a sibling
+static const int MIN_LEAF_KEYS = (MAX_FANOUT - 1) / 2;
+static const int MIN_INTERNAL_KEYS = (MAX_FANOUT - 1) / 2;
+
 /*
  * Delete keyTp & value pair associated with input keyTp
  * If current tree is empty, return immediately.
@@ -414,365 +322,300 @@ void BPlusTree::Remove(const KeyType &keyTp)
 {
     if (IsEmpty()) return;
 
-    Node *currNode = root, *parentNode;
-    int lSiblingValue, rSiblingValue, pointerPos ;
-    bool foundTheKey = false;
-
-    findNodeWhichHasGivenKey(keyTp, currNode, parentNode, lSiblingValue, rSiblingValue);
+    DescentPath path;
+    LeafNode *currNode = findLeafNode(keyTp, &path);
 
-    for (pointerPos = 0; pointerPos < currNode->key_num; pointerPos++) {
-        if (currNode->keys[pointerPos] == keyTp)  {
-            foundTheKey = true;
-            break;
-        }
-    }
-    if (foundTheKey) {
-        for (int currPosition = pointerPos; currPosition < currNode->key_num; currPosition++) {
-            currNode->keys[currPosition] = currNode->keys[currPosition + 1];
-            ((LeafNode *)currNode)->pointers[currPosition] = ((LeafNode *)currNode)->pointers[currPosition + 1];
-        }
-        currNode->key_num--;
-        if (currNode == root) {
-            for (int currIndex = 0; currIndex < MAX_FANOUT - 1; currIndex++) {
-                ((InternalNode *)currNode)->children[currIndex] = NULL;
-            }
-            if (currNode->key_num == 0) {
-                delete currNode;
-                root = NULL;
-            }
-//            printNode(root, 0);
-            return;
-        }
-        if (currNode->key_num >= (MAX_FANOUT - 1) / 2) {
-            // First Remove the KeyTp and then remove the parentNode
-            // leave if the node is half empty else merge the node
-            removeTheNodeWhichIsHalfFilled(keyTp, currNode);
-//            printNode(root, 0);
-            return;
-        }
-        if (lSiblingValue >= 0)
-        {
-            Node *leftChild = ((InternalNode *)parentNode)->children[lSiblingValue];
-            if (leftChild->key_num >= (MAX_FANOUT - 1) / 2 + 1) {
-                removeMoreThanHalfFilledLSibling(currNode, parentNode, lSiblingValue, leftChild);
-//                printNode(root, 0);
-                return;
-            }
-        }
-        if (rSiblingValue <= parentNode->key_num)
-        {
-            Node *rightChild = ((InternalNode *)parentNode)->children[rSiblingValue];
-            if (rightChild->key_num >= (MAX_FANOUT) / 2 + 1)
-            {
-                removeMoreThanHalfFilledRSibling(currNode, parentNode, rSiblingValue, rightChild);
-//                printNode(root, 0);
-                return;
-            }
-        }
-        if (lSiblingValue >= 0)
-        {
-            Node *leftNode = ((InternalNode *)parentNode)->children[lSiblingValue];
-            for (int index = leftNode->key_num, j = 0; j < currNode->key_num; index++, j++)
-            {
-                leftNode->keys[index] = currNode->keys[j];
-            }
-            ((InternalNode *)leftNode)->children[leftNode->key_num] = NULL;
-            leftNode->key_num += currNode->key_num;
-            ((InternalNode *)leftNode)->children[leftNode->key_num] = ((InternalNode *)currNode)->children[currNode->key_num];
-            removeNodeInInternalTree(parentNode->keys[lSiblingValue], parentNode, currNode);
-            delete currNode;
-        }
-        else if (rSiblingValue <= parentNode->key_num)
-        {
-            Node *rightNode = ((InternalNode *)parentNode)->children[rSiblingValue];
-            for (int index = currNode->key_num, j = 0; j < rightNode->key_num; index++, j++)
-            {
-                currNode->keys[index] = rightNode->keys[j];
-            }
-            ((InternalNode *)currNode)->children[currNode->key_num] = NULL;
-            currNode->key_num += rightNode->key_num;
-            ((InternalNode *)currNode)->children[currNode->key_num] = ((InternalNode *)currNode)->children[rightNode->key_num];
-            removeNodeInInternalTree(parentNode->keys[rSiblingValue - 1], parentNode, rightNode);
-            delete rightNode;
-        }
-//        printNode(root, 0);
-    } else {
+    int pointerPos = NodeLowerBound(currNode->keys, currNode->key_num, keyTp);
+    if (pointerPos == currNode->key_num || !(currNode->keys[pointerPos] == keyTp)) {
         cout << "Element not foundTheKey" << endl;
         return;
     }
-}
-
-/**
- * Remove the Half filled Right sibling
- * @param currNode currNode
- * @param parentNode parentNode
- * @param rSiblingValue rSiblingValue
- * @param rightChild rightChild
- */
-void BPlusTree::removeMoreThanHalfFilledRSibling(Node *currNode, Node *parentNode, int rSiblingValue,
-                                                 Node *rightChild) const {
-    currNode->key_num++;
-    ((InternalNode *)currNode)->children[currNode->key_num] = ((InternalNode *)currNode)->children[currNode->key_num - 1];
-    ((InternalNode *)currNode)->children[currNode->key_num - 1] = NULL;
-    currNode->keys[currNode->key_num - 1] = rightChild->keys[0];
-    rightChild->key_num--;
-    ((InternalNode *)rightChild)->children[rightChild->key_num] = ((InternalNode *)rightChild)->children[rightChild->key_num + 1];
-    ((InternalNode *)rightChild)->children[rightChild->key_num + 1] = NULL;
-    for (int index = 0; index < rightChild->key_num; index++)
-    {
-        rightChild->keys[index] = rightChild->keys[index + 1];
+    for (int currPosition = pointerPos; currPosition < currNode->key_num - 1; currPosition++) {
+        currNode->keys[currPosition] = currNode->keys[currPosition + 1];
+        currNode->pointers[currPosition] = currNode->pointers[currPosition + 1];
     }
-    parentNode->keys[rSiblingValue - 1] = rightChild->keys[0];
-}
-
-/**
- * Remove the Half filled Left sibling
- * @param currNode currNode
- * @param parentNode parentNode
- * @param rSiblingValue lSiblingValue
- * @param rightChild leftChild
- */
-void BPlusTree::removeMoreThanHalfFilledLSibling(Node *currNode, Node *parentNode, int lSiblingValue,
-                                                 Node *leftChild) const {
-    for (int index = currNode->key_num; index > 0; index--) {
-        currNode->keys[index] = currNode->keys[index - 1];
-    }
-    currNode->key_num++;
-    ((InternalNode *)currNode)->children[currNode->key_num] = ((InternalNode *)currNode)->children[currNode->key_num - 1];
-    ((InternalNode *)currNode)->children[currNode->key_num - 1] = NULL;
-    currNode->keys[0] = leftChild->keys[leftChild->key_num - 1];
-    leftChild->key_num--;
-    ((InternalNode *)leftChild)->children[leftChild->key_num] = currNode;
-    ((InternalNode *)leftChild)->children[leftChild->key_num + 1] = NULL;
-    parentNode->keys[lSiblingValue] = currNode->keys[0];
-}
+    currNode->key_num--;
 
-/**
- * Removes the node which are half filled
- * @param keyTp The keyTp to remove
- * @param currNode The currNode to remove
- */
-void BPlusTree::removeTheNodeWhichIsHalfFilled(const int &keyTp, const Node *currNode) const {
-    Node *parentContainTheKey = root;
-    bool parentFoundContainKey = false;
-    while (!parentFoundContainKey && !parentContainTheKey->is_leaf)
-    {
-        for (int i = 0; i < parentContainTheKey->key_num; i++)
-        {
-            if (keyTp < parentContainTheKey->keys[i])
-            {
-                parentContainTheKey = ((InternalNode *)parentContainTheKey)->children[i];
-                break;
-            }
-            if (keyTp == parentContainTheKey->keys[i])
-            {
-                parentContainTheKey->keys[i] = currNode->keys[0];
-                parentFoundContainKey = true;
-                break;
-            }
-            if (i == parentContainTheKey->key_num - 1)
-            {
-                parentContainTheKey = ((InternalNode *)parentContainTheKey)->children[i + 1];
-                break;
-            }
+    if (path.empty()) {
+        // the root is a leaf, the tree is empty once its last key is gone
+        if (currNode->key_num == 0) {
+            leaf_pool.Free(currNode);
+            root = NULL;
         }
+        return;
     }
-}
-
-/**
- * Finds the Node which has the given key and returns the currNode
- * @param keyTp keyTp
- * @param currNode The current Node
- * @param parentNode The parent Node
- * @param lSiblingValue The left sibling
- * @param rSiblingValue The right sibling
- */
-void BPlusTree::findNodeWhichHasGivenKey(const int &keyTp, Node *&currNode,
-                                         Node *&parentNode, int &lSiblingValue, int &rSiblingValue) const {
-    while (!currNode->is_leaf) {
-        for (int currIndex = 0; currIndex < currNode->key_num; currIndex++) {
-            parentNode = currNode;
-            lSiblingValue = currIndex - 1;
-            rSiblingValue = currIndex + 1;
-            if (keyTp < currNode->keys[currIndex]) {
-                currNode = ((InternalNode *) currNode)->children[currIndex];
-                break;
-            }
-            if (currIndex == currNode->key_num - 1) {
-                lSiblingValue = currIndex;
-                rSiblingValue = currIndex + 2;
-                currNode = ((InternalNode *)currNode)->children[currIndex + 1];
-                break;
-            }
-        }
+    // separators in the internal nodes still route correctly when a key is
+    // removed, so only an underfull leaf changes the structure
+    if (currNode->key_num < MIN_LEAF_KEYS) {
+        rebalanceLeafNode(currNode, path);
     }
 }
 
-
-
 /**
- * Remove a node in internal Tree for given key
- * @param keyTp The key to delete
- * @param currNode The curr Node which have to be deleted
- * @param childNode The child node to be deleted
+ * Refills an underfull leaf node from a sibling, or merges it with one
+ * @param currNode The underfull leaf node
+ * @param path The descent path, its last entry is the parent of currNode
  */
-void BPlusTree::removeNodeInInternalTree(KeyType keyTp, Node *currNode, Node *childNode) {
-    if (currNode == root && currNode->key_num == 1) {
-        removeRootNodeWith1Key(keyTp, currNode, childNode);
+void BPlusTree::rebalanceLeafNode(LeafNode *currNode, DescentPath &path)
+{
+    InternalNode *parentNode = path.back().node;
+    int childIndex = path.back().child_index;
+    LeafNode *leftChild = childIndex > 0 ? (LeafNode *)parentNode->children[childIndex - 1] : NULL;
+    LeafNode *rightChild = childIndex < parentNode->key_num ? (LeafNode *)parentNode->children[childIndex + 1] : NULL;
+
+    // borrow the last key of the left sibling
+    if (leftChild != NULL && leftChild->key_num > MIN_LEAF_KEYS) {
+        for (int index = currNode->key_num; index > 0; index--) {
+            currNode->keys[index] = currNode->keys[index - 1];
+            currNode->pointers[index] = currNode->pointers[index - 1];
+        }
+        leftChild->key_num--;
+        currNode->keys[0] = leftChild->keys[leftChild->key_num];
+        currNode->pointers[0] = leftChild->pointers[leftChild->key_num];
+        currNode->key_num++;
+        parentNode->keys[childIndex - 1] = currNode->keys[0];
         return;
     }
-    int currentPosition;
-    extractCurrNodePosOfTheKey(keyTp, currNode, childNode);
-    if (currNode->key_num >= (MAX_FANOUT - 1) / 2 - 1) return;
-    if (currNode == root) return;
-    Node *parent = parentNodeSearch(root, currNode);
-    int lSibling = 0, rSibling = 0;
-    for (currentPosition = 0; currentPosition < parent->key_num + 1; currentPosition++) {
-        if (((InternalNode *)parent)->children[currentPosition] == currNode) {
-            lSibling = currentPosition - 1;
-            rSibling = currentPosition + 1;
-            break;
-        }
-    }
-    if (lSibling >= 0) {
-        Node *leftChild = ((InternalNode *)parent)->children[lSibling];
-        if (leftChild->key_num >= (MAX_FANOUT - 1) / 2) {
-            removeLSiblingOfLChild(currNode, parent, lSibling, leftChild);
-            return;
+    // borrow the first key of the right sibling
+    if (rightChild != NULL && rightChild->key_num > MIN_LEAF_KEYS) {
+        currNode->keys[currNode->key_num] = rightChild->keys[0];
+        currNode->pointers[currNode->key_num] = rightChild->pointers[0];
+        currNode->key_num++;
+        for (int index = 0; index < rightChild->key_num - 1; index++) {
+            rightChild->keys[index] = rightChild->keys[index + 1];
+            rightChild->pointers[index] = rightChild->pointers[index + 1];
         }
+        rightChild->key_num--;
+        parentNode->keys[childIndex] = rightChild->keys[0];
+        return;
     }
-    if (rSibling <= parent->key_num) {
-        Node *rightChild = ((InternalNode *)parent)->children[rSibling];
-        if (rightChild->key_num >= (MAX_FANOUT - 1) / 2) {
-            removeRSiblingOfRChild(currNode, currentPosition, parent, rightChild);
-            return;
-        }
+    // merge into the left node of the pair and drop the right one
+    if (leftChild == NULL) {
+        leftChild = currNode;
+        currNode = rightChild;
+        childIndex++;
     }
-    if (lSibling >= 0) {
-        traverseTheLChildToRemove(currNode, parent, lSibling);
-        removeNodeInInternalTree(parent->keys[lSibling], parent, currNode);
+    for (int index = 0; index < currNode->key_num; index++) {
+        leftChild->keys[leftChild->key_num + index] = currNode->keys[index];
+        leftChild->pointers[leftChild->key_num + index] = currNode->pointers[index];
     }
-    else if (rSibling <= parent->key_num) {
-        Node *rightChild = traverseRSiblinginRChild(currNode, parent, rSibling);
-        removeNodeInInternalTree(parent->keys[rSibling - 1], parent, rightChild);
+    leftChild->key_num += currNode->key_num;
+    leftChild->next_leaf = currNode->next_leaf;
+    if (leftChild->next_leaf != NULL) {
+        leftChild->next_leaf->prev_leaf = leftChild;
     }
+    leaf_pool.Free(currNode);
+    removeNodeInInternalTree(path, childIndex - 1, childIndex);
 }
 
 /**
- * Extract the current node position of the key
- * @param keyTp keyTp
- * @param currNode current Node
- * @param childNode child Node
+ * Remove a key and a child from an internal node, then rebalance it if it is underfull
+ * @param path The descent path, its last entry is the internal node
+ * @param keyIndex The position of the key to remove
+ * @param childIndex The position of the child to remove
  */
-void BPlusTree::extractCurrNodePosOfTheKey(int keyTp, Node *currNode, const Node *childNode) const {
-    int currentPosition = 0;
-    while(currentPosition < currNode->key_num) {
-        if (currNode->keys[currentPosition] == keyTp) {
-            break;
-        }
-        currentPosition++;
-    }
-    for (int currIndex = currentPosition; currIndex < currNode->key_num; currIndex++) {
-        currNode->keys[currIndex] = currNode->keys[currIndex + 1];
-    }
-    for (currentPosition = 0; currentPosition < currNode->key_num + 1; currentPosition++) {
-        if (((InternalNode *)currNode)->children[currentPosition] == childNode) {
-            break;
-        }
+void BPlusTree::removeNodeInInternalTree(DescentPath &path, int keyIndex, int childIndex)
+{
+    InternalNode *currNode = path.back().node;
+    path.pop_back();
+    for (int index = keyIndex; index < currNode->key_num - 1; index++) {
+        currNode->keys[index] = currNode->keys[index + 1];
     }
-    for (int currIndex = currentPosition; currIndex < currNode->key_num + 1; currIndex++) {
-        ((InternalNode *)currNode)->children[currIndex] = ((InternalNode *)currNode)->children[currIndex + 1];
+    for (int index = childIndex; index < currNode->key_num; index++) {
+        currNode->children[index] = currNode->children[index + 1];
     }
     currNode->key_num--;
-}
 
-Node *BPlusTree::traverseRSiblinginRChild(Node *currNode, const Node *parent, int rSibling) const {
-    Node *rightChild = ((InternalNode *)parent)->children[rSibling];
-    currNode->keys[currNode->key_num] = parent->keys[rSibling - 1];
-    for (int index = currNode->key_num + 1, j = 0; j < rightChild->key_num; j++) {
-        currNode->keys[index] = rightChild->keys[j];
+    if (path.empty()) {
+        // a root without keys has a single child, which becomes the root
+        if (currNode->key_num == 0) {
+            root = currNode->children[0];
+            internal_pool.Free(currNode);
+        }
+        return;
     }
-    for (int index = currNode->key_num + 1, j = 0; j < rightChild->key_num + 1; j++) {
-        ((InternalNode *)currNode)->children[index] = ((InternalNode *)rightChild)->children[j];
-        ((InternalNode *)rightChild)->children[j] = NULL;
+    if (currNode->key_num < MIN_INTERNAL_KEYS) {
+        rebalanceInternalNode(currNode, path);
     }
-    currNode->key_num += rightChild->key_num + 1;
-    rightChild->key_num = 0;
-    return rightChild;
 }
 
-void BPlusTree::traverseTheLChildToRemove(Node *currNode, const Node *parent, int lSibling) const {
-    try {
-        Node *leftChild = ((InternalNode *)parent)->children[lSibling];
-        leftChild->keys[leftChild->key_num] = parent->keys[lSibling];
-        for (int currIndex = leftChild->key_num + 1, currNodeIndex = 0; currNodeIndex < currNode->key_num; currNodeIndex++) {
-            leftChild->keys[currIndex] = currNode->keys[currNodeIndex];
+/**
+ * Refills an underfull internal node through its parent from a sibling, or merges it with one
+ * @param currNode The underfull internal node
+ * @param path The descent path, its last entry is the parent of currNode
+ */
+void BPlusTree::rebalanceInternalNode(InternalNode *currNode, DescentPath &path)
+{
+    InternalNode *parentNode = path.back().node;
+    int childIndex = path.back().child_index;
+    InternalNode *leftChild = childIndex > 0 ? (InternalNode *)parentNode->children[childIndex - 1] : NULL;
+    InternalNode *rightChild = childIndex < parentNode->key_num ? (InternalNode *)parentNode->children[childIndex + 1] : NULL;
+
+    // rotate the last child of the left sibling through the parent
+    if (leftChild != NULL && leftChild->key_num > MIN_INTERNAL_KEYS) {
+        for (int index = currNode->key_num; index > 0; index--) {
+            currNode->keys[index] = currNode->keys[index - 1];
         }
-        for (int currIndex = leftChild->key_num + 1, currNodeIndex = 0; currNodeIndex < currNode->key_num + 1; currNodeIndex++) {
-            ((InternalNode *)leftChild)->children[currIndex] = ((InternalNode *)currNode)->children[currNodeIndex];
-            ((InternalNode *)currNode)->children[currNodeIndex] = NULL;
+        for (int index = currNode->key_num + 1; index > 0; index--) {
+            currNode->children[index] = currNode->children[index - 1];
         }
-        leftChild->key_num += currNode->key_num + 1;
-        currNode->key_num = 0;
-    } catch(std::exception& e){
-        cout<<"Error in traverseTheLChildToRemove method"<<e.what()<<endl;
+        currNode->keys[0] = parentNode->keys[childIndex - 1];
+        currNode->children[0] = leftChild->children[leftChild->key_num];
+        currNode->key_num++;
+        parentNode->keys[childIndex - 1] = leftChild->keys[leftChild->key_num - 1];
+        leftChild->key_num--;
+        return;
     }
-}
-
-void BPlusTree::removeRSiblingOfRChild(Node *currNode, int currentPosition, Node *parent, Node *rightChild) const {
-    currNode->keys[currNode->key_num] = parent->keys[currentPosition];
-    parent->keys[currentPosition] = rightChild->keys[0];
-    for (int currIndex = 0; currIndex < rightChild->key_num - 1; currIndex++) {
-        rightChild->keys[currIndex] = rightChild->keys[currIndex + 1];
+    // rotate the first child of the right sibling through the parent
+    if (rightChild != NULL && rightChild->key_num > MIN_INTERNAL_KEYS) {
+        currNode->keys[currNode->key_num] = parentNode->keys[childIndex];
+        currNode->children[currNode->key_num + 1] = rightChild->children[0];
+        currNode->key_num++;
+        parentNode->keys[childIndex] = rightChild->keys[0];
+        for (int index = 0; index < rightChild->key_num - 1; index++) {
+            rightChild->keys[index] = rightChild->keys[index + 1];
+        }
+        for (int index = 0; index < rightChild->key_num; index++) {
+            rightChild->children[index] = rightChild->children[index + 1];
+        }
+        rightChild->key_num--;
+        return;
     }
-    ((InternalNode *)currNode)->children[currNode->key_num + 1] = ((InternalNode *)rightChild)->children[0];
-    for (int currIndex = 0; currIndex < rightChild->key_num; ++currIndex) {
-        ((InternalNode *)rightChild)->children[currIndex] = ((InternalNode *)rightChild)->children[currIndex + 1];
+    // merge into the left node of the pair, pulling the separator down, and drop the right one
+    if (leftChild == NULL) {
+        leftChild = currNode;
+        currNode = rightChild;
+        childIndex++;
     }
-    currNode->key_num++;
-    rightChild->key_num--;
-}
-
-void BPlusTree::removeLSiblingOfLChild(Node *currNode, Node *parent, int lSibling, Node *leftChild) const {
-    for (int currIndex = currNode->key_num; currIndex > 0; currIndex--) {
-        currNode->keys[currIndex] = currNode->keys[currIndex - 1];
+    leftChild->keys[leftChild->key_num] = parentNode->keys[childIndex - 1];
+    for (int index = 0; index < currNode->key_num; index++) {
+        leftChild->keys[leftChild->key_num + 1 + index] = currNode->keys[index];
     }
-    currNode->keys[0] = parent->keys[lSibling];
-    parent->keys[lSibling] = leftChild->keys[leftChild->key_num - 1];
-    for (int currIndex = currNode->key_num + 1; currIndex > 0; currIndex--) {
-        ((InternalNode *)currNode)->children[currIndex] = ((InternalNode *)currNode)->children[currIndex - 1];
+    for (int index = 0; index < currNode->key_num + 1; index++) {
+        leftChild->children[leftChild->key_num + 1 + index] = currNode->children[index];
     }
-    ((InternalNode *)currNode)->children[0] = ((InternalNode *)leftChild)->children[leftChild->key_num];
-    currNode->key_num++;
-    leftChild->key_num--;
+    leftChild->key_num += currNode->key_num + 1;
+    internal_pool.Free(currNode);
+    removeNodeInInternalTree(path, childIndex - 1, childIndex);
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
 /**
- * Remove the Root node which has only 1 key
- * @param keyTp keyTp
- * @param currNode The current Node
- * @param childNode The child Node
+ * Splits count entries into consecutive nodes of about target entries each,
+ * so that every node holds between min_size and max_size entries.
+ * A single node may hold fewer than min_size, it becomes the root.
+ * @param count The number of entries
+ * @param target The number of entries per node asked for by the fill factor
+ * @param min_size The fewest entries a non-root node may hold
+ * @param max_size The most entries a node may hold
+ * @param sizes Receives the number of entries of each node
  */
-void BPlusTree::removeRootNodeWith1Key(int keyTp, const Node *currNode, const Node *childNode) {
-    try {
-        if (((InternalNode *)currNode)->children[1] == childNode)
-        {
-            delete childNode;
-            root = ((InternalNode *)currNode)->children[0];
-            delete currNode;
-        } else if (((InternalNode *)currNode)->children[0] == childNode) {
-            delete childNode;
-            root = ((InternalNode *)currNode)->children[1];
-            delete currNode;
-        } else if (keyTp == currNode->keys[0]) {
-            delete childNode;
-            root = ((InternalNode *)currNode)->children[1];
-            delete currNode;
+static void planNodeSizes(size_t count, int target, int min_size, int max_size, vector<int> &sizes)
+{
+    sizes.assign(count / target, target);
+    int rest = (int)(count % target);
+    if (rest == 0) return;
+    if (sizes.empty() || rest >= min_size) {
+        sizes.push_back(rest);
+    } else if (sizes.back() + rest <= max_size) {
+        // too few left for a node of their own, the previous node takes them
+        sizes.back() += rest;
+    } else {
+        // share the last two nodes' entries evenly, both halves are above min_size
+        int total = sizes.back() + rest;
+        sizes.back() = total / 2;
+        sizes.push_back(total - total / 2);
+    }
+}
+
+/*
+ * Build the tree bottom-up from key & value pairs: first the leaf level,
+ * each leaf filled up to the fill factor and linked to its neighbours, then
+ * every internal level over the one below, until a single root is left.
+ * Entries that are not sorted by key are stable sorted in a copy, entries
+ * itself is never changed; for a duplicated key only the first entry is
+ * loaded, as Insert would.
+ * @return : the number of keys loaded, 0 if the tree is not empty
+ */
+size_t BPlusTree::BulkLoad(const vector<pair<KeyType, RecordPointer>> &entries, double fill_factor)
+{
+    if (!IsEmpty()) {
+        cout << "ERROR: BulkLoad needs an empty tree" << endl;
+        return 0;
+    }
+    if (entries.empty()) return 0;
+
+    // the caller's entries are left as they are, unsorted input is sorted in a copy
+    const vector<pair<KeyType, RecordPointer>> *sorted = &entries;
+    vector<pair<KeyType, RecordPointer>> sortedCopy;
+    if (!is_sorted(entries.begin(), entries.end(), compareEntryKeys)) {
+        sortedCopy = entries;
+        stable_sort(sortedCopy.begin(), sortedCopy.end(), compareEntryKeys);
+        sorted = &sortedCopy;
+    }
+    // only the first entry of each key is loaded
+    size_t count = 0;
+    for (size_t index = 0; index < sorted->size(); index++) {
+        if (index == 0 || (*sorted)[index - 1].first != (*sorted)[index].first) count++;
+    }
+
+    fill_factor = fill_factor > 1.0 ? 1.0 : fill_factor;
+    int leafTarget = (int)lround((MAX_FANOUT - 1) * fill_factor);
+    leafTarget = max(leafTarget, max(MIN_LEAF_KEYS, 1));
+    int childTarget = (int)lround(MAX_FANOUT * fill_factor);
+    childTarget = max(childTarget, MIN_INTERNAL_KEYS + 1);
+
+    // leaf level
+    vector<int> sizes;
+    planNodeSizes(count, leafTarget, MIN_LEAF_KEYS, MAX_FANOUT - 1, sizes);
+    vector<Node *> level(sizes.size());
+    vector<KeyType> firstKeys(sizes.size());
+    LeafNode *prevLeaf = NULL;
+    size_t entry = 0;
+    for (size_t node = 0; node < sizes.size(); node++) {
+        LeafNode *leaf = newLeafNode();
+        for (int index = 0; index < sizes[node]; index++, entry++) {
+            while (entry > 0 && (*sorted)[entry - 1].first == (*sorted)[entry].first) entry++;
+            leaf->keys[index] = (*sorted)[entry].first;
+            leaf->pointers[index] = (*sorted)[entry].second;
+        }
+        leaf->key_num = sizes[node];
+        leaf->prev_leaf = prevLeaf;
+        if (prevLeaf != NULL) prevLeaf->next_leaf = leaf;
+        prevLeaf = leaf;
+        level[node] = leaf;
+        firstKeys[node] = leaf->keys[0];
+    }
+
+    // internal levels, each child after the first is separated by its first key
+    while (level.size() > 1) {
+        planNodeSizes(level.size(), childTarget, MIN_INTERNAL_KEYS + 1, MAX_FANOUT, sizes);
+        vector<Node *> upperLevel(sizes.size());
+        vector<KeyType> upperFirstKeys(sizes.size());
+        size_t child = 0;
+        for (size_t node = 0; node < sizes.size(); node++) {
+            InternalNode *internal = newInternalNode();
+            upperFirstKeys[node] = firstKeys[child];
+            for (int index = 0; index < sizes[node]; index++, child++) {
+                internal->children[index] = level[child];
+                if (index > 0) internal->keys[index - 1] = firstKeys[child];
+            }
+            internal->key_num = sizes[node] - 1;
+            upperLevel[node] = internal;
         }
-    } catch (std::exception& e) {
-        cout<<"Exception occurred in removeRootNodeWith1Key "<<e.what()<<endl;
+        level.swap(upperLevel);
+        firstKeys.swap(upperFirstKeys);
     }
+    root = level[0];
+    return count;
+}
 
+/** Orders bulk load entries by key */
+bool BPlusTree::compareEntryKeys(const pair<KeyType, RecordPointer> &left, const pair<KeyType, RecordPointer> &right)
+{
+    return left.first < right.first;
 }
 
 /*****************************************************************************
@@ -781,36 +624,96 @@ void BPlusTree::removeRootNodeWith1Key(int keyTp, const Node *currNode, const No
 /*
  * Return the values that within the given key range
  * First find the node large or equal to the key_start, then traverse the leaf
- * nodes until meet the key_end position, fetch all the records.
+ * nodes until passing the key_end position, fetch all the records. Unlike
+ * Scan, the range includes key_end, as it always has.
  */
 void BPlusTree::RangeScan(const KeyType &key_start, const KeyType &key_end,
                           std::vector<RecordPointer> &result)
 {
-    if (IsEmpty()) return;
+    for (RangeCursor cursor = ScanFrom(key_start); !cursor.IsEnd() && !(key_end < cursor.Key()); ++cursor) {
+        result.push_back(cursor.Value());
+    }
+}
 
-    // find node large or equal to key_start
+/*
+ * Return a cursor on the first value with a key large or equal to key_start.
+ * The cursor ends at the first key large or equal to key_end.
+ */
+RangeCursor BPlusTree::Scan(const KeyType &key_start, const KeyType &key_end) const
+{
+    return seekInLeaf(key_start, key_end, true);
+}
+
+/*
+ * Return a cursor on the first value with a key large or equal to key_start.
+ * The cursor runs to the last leaf node.
+ */
+RangeCursor BPlusTree::ScanFrom(const KeyType &key_start) const
+{
+    return seekInLeaf(key_start, key_start, false);
+}
+
+/**
+ * Descends to the leaf node that may hold the given key
+ * @param keyTp The key to search for
+ * @param path If not NULL, receives the internal nodes passed through and the child taken in each
+ * @return The leaf node, NULL if the tree is empty
+ */
+LeafNode *BPlusTree::findLeafNode(const KeyType &keyTp, DescentPath *path) const
+{
+    if (IsEmpty()) return NULL;
     Node *currentNode = root;
     while (!currentNode->is_leaf) {
-        for (int currIndex = 0; currIndex < currentNode->key_num; currIndex++) {
-            if (key_start < currentNode->keys[currIndex]) {
-                currentNode = ((InternalNode *)currentNode)->children[currIndex];
-                break;
-            }
-            if (currIndex == currentNode->key_num - 1) {
-                currentNode = ((InternalNode *)currentNode)->children[currIndex + 1];
-                break;
-            }
+        InternalNode *internal = (InternalNode *)currentNode;
+        int childIndex = NodeUpperBound(internal->keys, internal->key_num, keyTp);
+        if (path != NULL) {
+            PathEntry entry = {internal, childIndex};
+            path->push_back(entry);
         }
+        currentNode = internal->children[childIndex];
+        PrefetchNodeKeys(currentNode);
     }
-    if (currentNode->is_leaf) {
-        while (currentNode != NULL) {
-            for (int currentIndex = 0; currentIndex < currentNode->key_num; currentIndex++) {
-                if (currentNode->keys[currentIndex] >= key_start and currentNode->keys[currentIndex] <= key_end) {
-                    result.push_back(((LeafNode *)currentNode)->pointers[currentIndex]);
-                }
-            }
-            currentNode = ((LeafNode *)currentNode)->next_leaf;
-        }
+    return (LeafNode *)currentNode;
+}
+
+/**
+ * Positions a cursor on the first key large or equal to key_start
+ * @param key_start The first key of the range
+ * @param key_end The end of the range, not included
+ * @param bounded Whether the range ends at key_end or at the last leaf node
+ * @return The cursor, at its end if no key is in the range
+ */
+RangeCursor BPlusTree::seekInLeaf(const KeyType &key_start, const KeyType &key_end, bool bounded) const
+{
+    LeafNode *leaf = findLeafNode(key_start);
+    if (leaf == NULL) return RangeCursor();
+    return RangeCursor(leaf, NodeLowerBound(leaf->keys, leaf->key_num, key_start), key_end, bounded);
+}
+
+RangeCursor::RangeCursor(LeafNode *leafNode, int keyIndex, const KeyType &keyEnd, bool isBounded)
+    : leaf(leafNode), index(keyIndex), key_end(keyEnd), bounded(isBounded)
+{
+    settle();
+}
+
+RangeCursor &RangeCursor::operator++()
+{
+    index++;
+    settle();
+    return *this;
+}
+
+void RangeCursor::settle()
+{
+    while (leaf != NULL && index >= leaf->key_num) {
+        leaf = leaf->next_leaf;
+        index = 0;
+        // the following leaf loads while this one is read
+        if (leaf != NULL && leaf->next_leaf != NULL) PrefetchNodeKeys(leaf->next_leaf);
+    }
+    // keys are sorted along the leaf chain, nothing after key_end can match
+    if (leaf != NULL && bounded && !(leaf->keys[index] < key_end)) {
+        leaf = NULL;
     }
 }
 
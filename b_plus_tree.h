@@ -10,13 +10,31 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
+#include "node_pool.h"
 #include "para.h"
 
 using namespace std;
 
+// Share of each node BulkLoad fills, the rest is left for later inserts
+static const double DEFAULT_FILL_FACTOR = 0.9;
+
+// Bytes a leaf node may take up, a multiple of the cache line. Unless
+// MAX_FANOUT is set in para.h or on the command line, it is the largest
+// fanout whose leaf nodes fit in this size.
+#ifndef BPLUS_NODE_BYTES
+#define BPLUS_NODE_BYTES 1024
+#endif
+
+// Nodes start on a cache line, as the node pools hand them out
+static const size_t NODE_CACHE_LINE = NODE_POOL_ALIGNMENT;
+
 // Value structure we insert into BPlusTree
 struct RecordPointer
 {
@@ -26,32 +44,149 @@ struct RecordPointer
     RecordPointer(int page, int record) : page_id(page), record_id(record){};
 };
 
-// BPlusTree Node
-class Node
+// Header of every BPlusTree node
+struct NodeHeader
 {
-public:
-    Node(bool leaf) : key_num(0), is_leaf(leaf){};
+    NodeHeader(bool leaf) : is_leaf(leaf), key_num(0){};
     bool is_leaf;
     int key_num;
+};
+
+#ifndef MAX_FANOUT
+// a leaf holds the node header, MAX_FANOUT - 1 keys and record pointers, and two leaf links
+#define MAX_FANOUT ((int)((BPLUS_NODE_BYTES - sizeof(NodeHeader) - 2 * sizeof(void *)) / (sizeof(KeyType) + sizeof(RecordPointer))) + 1)
+#define BPLUS_FANOUT_FROM_NODE_BYTES
+#endif
+
+// BPlusTree Node
+// Every node starts on a cache line with its header, followed by all of its
+// keys and only then by its record pointers or children. A search of the node
+// reads just the leading lines that hold the keys, and a small node has its
+// header and keys in one line. The header is a parameter so that a tree can
+// keep more per node (ConcurrentBPlusTree adds a version latch) without
+// growing the nodes of the others.
+template <typename Header>
+class alignas(NODE_CACHE_LINE) BasicNode : public Header
+{
+public:
+    BasicNode(bool leaf) : Header(leaf){};
     KeyType keys[MAX_FANOUT - 1];
 };
 
 // internal b+ tree node
-class InternalNode : public Node
+template <typename Header>
+class BasicInternalNode : public BasicNode<Header>
 {
 public:
-    InternalNode() : Node(false){};
-    Node *children[MAX_FANOUT];
+    BasicInternalNode() : BasicNode<Header>(false){};
+    BasicNode<Header> *children[MAX_FANOUT];
 };
 
-class LeafNode : public Node
+template <typename Header>
+class BasicLeafNode : public BasicNode<Header>
 {
 public:
-    LeafNode() : Node(true){};
+    BasicLeafNode() : BasicNode<Header>(true){};
     RecordPointer pointers[MAX_FANOUT - 1];
     // pointer to the next/prev leaf node
-    LeafNode *next_leaf = NULL;
-    LeafNode *prev_leaf = NULL;
+    BasicLeafNode *next_leaf = NULL;
+    BasicLeafNode *prev_leaf = NULL;
+};
+
+typedef BasicNode<NodeHeader> Node;
+typedef BasicInternalNode<NodeHeader> InternalNode;
+typedef BasicLeafNode<NodeHeader> LeafNode;
+
+#ifdef BPLUS_FANOUT_FROM_NODE_BYTES
+static_assert(sizeof(LeafNode) <= BPLUS_NODE_BYTES, "leaf nodes must fit in BPLUS_NODE_BYTES");
+static_assert(sizeof(InternalNode) <= BPLUS_NODE_BYTES, "internal nodes must fit in BPLUS_NODE_BYTES");
+#endif
+
+/**
+ * Starts loading the cache lines of a node that a search of its keys reads,
+ * so that they arrive together instead of one miss at a time as a binary
+ * search reaches them. Prefetching never faults, so the node may be stale.
+ * @param node The node about to be searched
+ */
+template <typename NodeType>
+inline void PrefetchNodeKeys(const NodeType *node)
+{
+#ifdef __GNUC__
+    const char *line = reinterpret_cast<const char *>(node);
+    const char *end = reinterpret_cast<const char *>(node->keys + (MAX_FANOUT - 1));
+    for (; line < end; line += NODE_CACHE_LINE) {
+        __builtin_prefetch(line);
+    }
+#else
+    (void)node;
+#endif
+}
+
+// One step of a descent from the root: the internal node passed through and the child taken
+struct PathEntry
+{
+    InternalNode *node;
+    int child_index;
+};
+
+// Most internal levels a tree can have: every internal node has at least two
+// children, so a deeper tree would hold more keys than memory can address
+static const int MAX_TREE_HEIGHT = 64;
+
+// Internal nodes from the root down to the parent of a leaf. Splits and merges
+// walk it back up instead of searching the tree for a node's parent. It lives
+// on the stack, so a descent never allocates.
+class DescentPath
+{
+public:
+    DescentPath() : depth(0){};
+
+    bool empty() const { return depth == 0; }
+    void push_back(const PathEntry &entry)
+    {
+        assert(depth < MAX_TREE_HEIGHT);
+        entries[depth++] = entry;
+    }
+    void pop_back() { depth--; }
+    PathEntry &back() { return entries[depth - 1]; }
+
+private:
+    PathEntry entries[MAX_TREE_HEIGHT];
+    int depth;
+};
+
+/**
+ * Read-only cursor over the leaf entries of a key range, in key order.
+ * Results are pulled one entry at a time by walking the leaf chain, so a
+ * scan needs constant memory and can stop at any point. It stays valid until
+ * the tree is modified.
+ */
+class RangeCursor
+{
+public:
+    RangeCursor() : leaf(NULL), index(0), key_end(), bounded(false){};
+
+    // Returns true once every entry of the range has been visited
+    bool IsEnd() const { return leaf == NULL; }
+
+    // Key and record pointer of the current entry
+    const KeyType &Key() const { return leaf->keys[index]; }
+    const RecordPointer &Value() const { return leaf->pointers[index]; }
+
+    // Move to the next entry of the range
+    RangeCursor &operator++();
+
+private:
+    friend class BPlusTree;
+    RangeCursor(LeafNode *leafNode, int keyIndex, const KeyType &keyEnd, bool isBounded);
+
+    // Skip exhausted leaves and stop at the first key beyond key_end
+    void settle();
+
+    LeafNode *leaf;
+    int index;
+    KeyType key_end;
+    bool bounded;
 };
 
 /**
@@ -74,6 +209,16 @@ public:
         root = NULL;
     };
 
+    // Releases every node of the tree at once through the node pools
+    ~BPlusTree()
+    {
+        leaf_pool.Reset();
+        internal_pool.Reset();
+    };
+
+    BPlusTree(const BPlusTree &) = delete;
+    BPlusTree &operator=(const BPlusTree &) = delete;
+
     // Returns true if this B+ tree has no keys and values
     bool IsEmpty() const;
 
@@ -86,55 +231,55 @@ public:
     // return the value associated with a given keyTp
     bool GetValue(const KeyType &keyTp, RecordPointer &result);
 
-    // return the values within a key range [key_start, key_end) not included key_end
+    // return the values within a key range [key_start, key_end], key_end included
     void RangeScan(const KeyType &key_start, const KeyType &key_end,
                    std::vector<RecordPointer> &result);
 
+    // return a cursor over the values within [key_start, key_end)
+    RangeCursor Scan(const KeyType &key_start, const KeyType &key_end) const;
 
-    // pointer to the root node.
-    Node *root;
-
-    // Below all are my Helper Functions
-    bool insertNodeInInternalTree(KeyType keyTp, Node *parentNode, Node *childNode);
-    Node* parentNodeSearch(Node *currentNode, Node *childNode);
+    // return a cursor over the values from key_start to the end of the tree
+    RangeCursor ScanFrom(const KeyType &key_start) const;
 
+    // build an empty tree from key-value pairs, leaves filled up to fill_factor
+    size_t BulkLoad(const std::vector<std::pair<KeyType, RecordPointer>> &entries,
+                    double fill_factor = DEFAULT_FILL_FACTOR);
 
-    void removeNodeInInternalTree(KeyType keyTp, Node *currNode, Node *childNode);
-
-
-    void printNode(Node *node, int level);
 
-    static void findLeafNodeToInsertNewKey(const int &key, Node *&currNode, Node *&parent);
+    // return the bytes held by the nodes of this B+ tree
+    size_t MemoryUsage() const { return leaf_pool.MemoryUsage() + internal_pool.MemoryUsage(); }
 
-    bool insertInCurrNodeAvlSlot(const int &key, const RecordPointer &value, Node *currNode);
-
-    bool insertInNewNodeAndRearrange(const int &key, const RecordPointer &value, Node *currNode, Node *parent);
-
-    bool insertInRootNode(Node *currNode, Node *newLeafNode);
+    // pointer to the root node.
+    Node *root;
 
-    static bool insertKeyInParentAvlSlot(int keyTp, Node *parentNode, Node *childNode) ;
+    // cache-line-aligned storage of the nodes, merged nodes are reused by later splits
+    NodePool<LeafNode> leaf_pool;
+    NodePool<InternalNode> internal_pool;
 
-    bool insertInTreeByCreatingNewNode(int keyTp, Node *parentNode, Node *childNode);
+    // Below all are my Helper Functions
+    LeafNode *newLeafNode() { return leaf_pool.Allocate(); }
+    InternalNode *newInternalNode() { return internal_pool.Allocate(); }
+    LeafNode *findLeafNode(const KeyType &keyTp, DescentPath *path = NULL) const;
+    RangeCursor seekInLeaf(const KeyType &key_start, const KeyType &key_end, bool bounded) const;
+    static bool compareEntryKeys(const pair<KeyType, RecordPointer> &left, const pair<KeyType, RecordPointer> &right);
 
-    void
-    findNodeWhichHasGivenKey(const int &keyTp, Node *&currNode, Node *&parentNode, int &lSiblingValue,
-                             int &rSiblingValue) const;
+    bool insertInCurrNodeAvlSlot(const int &key, const RecordPointer &value, LeafNode *currNode);
 
-    void removeTheNodeWhichIsHalfFilled(const int &keyTp, const Node *currNode) const;
+    bool insertInNewNodeAndRearrange(const int &key, const RecordPointer &value, LeafNode *currNode, DescentPath &path);
 
-    void removeMoreThanHalfFilledLSibling(Node *currNode, Node *parentNode, int lSiblingValue, Node *leftChild) const;
+    bool insertInRootNode(KeyType keyTp, Node *currNode, Node *newNode);
 
-    void removeMoreThanHalfFilledRSibling(Node *currNode, Node *parentNode, int rSiblingValue, Node *rightChild) const;
+    bool insertNodeInInternalTree(KeyType keyTp, DescentPath &path, Node *childNode);
 
-    void removeRootNodeWith1Key(int keyTp, const Node *currNode, const Node *childNode);
+    static bool insertKeyInParentAvlSlot(int keyTp, InternalNode *parentNode, int childIndex, Node *childNode);
 
-    void removeLSiblingOfLChild(Node *currNode, Node *parent, int lSibling, Node *leftChild) const;
+    bool insertInTreeByCreatingNewNode(int keyTp, DescentPath &path, Node *childNode);
 
-    void removeRSiblingOfRChild(Node *currNode, int currentPosition, Node *parent, Node *rightChild) const;
+    void rebalanceLeafNode(LeafNode *currNode, DescentPath &path);
 
-    void traverseTheLChildToRemove(Node *currNode, const Node *parent, int lSibling) const;
+    void removeNodeInInternalTree(DescentPath &path, int keyIndex, int childIndex);
 
-    Node *traverseRSiblinginRChild(Node *currNode, const Node *parent, int rSibling) const;
+    void rebalanceInternalNode(InternalNode *currNode, DescentPath &path);
 
-    void extractCurrNodePosOfTheKey(int keyTp, Node *currNode, const Node *childNode) const;
+    void printNode(Node *node, int level);
 };
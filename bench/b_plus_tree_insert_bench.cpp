@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "b_plus_tree.h"
+#include "bench.h"
+
+// Every operator new of the process is counted; nodes come from the node
+// pools' slabs, which are allocated with posix_memalign and not counted
+static size_t num_allocations = 0;
+
+void *operator new(size_t size)
+{
+    num_allocations++;
+    void *memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == NULL) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+// Inserts never allocate outside the slabs except to grow the pools' slab lists
+static const double MAX_ALLOCATIONS_PER_INSERT = 0.001;
+
+/*
+ * Inserts keys in pseudo-random order into a BPlusTree and reports the time
+ * and the number of heap allocations per insert.
+ * usage: b_plus_tree_insert_bench [--keys N]
+ */
+int main(int argc, char **argv)
+{
+    const size_t num_keys = SizeOption(argc - 1, argv + 1, "--keys", 2000000);
+    std::vector<int> keys(num_keys);
+    for (size_t i = 0; i < num_keys; i++) {
+        keys[i] = (int)((i * 2654435761u) % 4000037u);
+    }
+
+    BPlusTree tree;
+    const size_t allocations_before = num_allocations;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_keys; i++) {
+        tree.Insert(keys[i], RecordPointer(0, (int)i));
+    }
+    const double seconds = SecondsSince(start);
+    const double per_insert = (double)(num_allocations - allocations_before) / num_keys;
+
+    std::printf("fanout %d, %zu keys: %.1f ns/insert, %.6f heap allocations/insert, %zu KB of nodes\n",
+                MAX_FANOUT, num_keys, seconds * 1e9 / num_keys, per_insert, tree.MemoryUsage() / 1024);
+    if (per_insert > MAX_ALLOCATIONS_PER_INSERT) {
+        std::printf("FAILED: more than %.3f heap allocations per insert\n", MAX_ALLOCATIONS_PER_INSERT);
+        return 1;
+    }
+    return 0;
+}
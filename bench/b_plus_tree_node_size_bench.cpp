@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree.h"
+#include "bench.h"
+
+// Entries each range scan visits
+static const int SCAN_LENGTH = 10000;
+
+/*
+ * Inserts keys in random order into a BPlusTree, looks each of them up in
+ * another random order and scans ranges of them, reporting the time per
+ * operation. It is built once per node size as
+ * b_plus_tree_node_size_bench_<BPLUS_NODE_BYTES>, see CMakeLists.txt.
+ * usage: b_plus_tree_node_size_bench_<bytes> [--keys N] [--scans N]
+ */
+int main(int argc, char **argv)
+{
+    const size_t num_keys = SizeOption(argc - 1, argv + 1, "--keys", 4000000);
+    const size_t num_scans = std::min(SizeOption(argc - 1, argv + 1, "--scans", 2000), num_keys);
+    std::vector<int> keys(num_keys);
+    for (size_t i = 0; i < num_keys; i++) {
+        keys[i] = (int)i * 2;
+    }
+    std::mt19937 rng(7);
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    BPlusTree tree;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_keys; i++) {
+        tree.Insert(keys[i], RecordPointer(0, keys[i]));
+    }
+    const double insert_seconds = SecondsSince(start);
+
+    std::shuffle(keys.begin(), keys.end(), rng);
+    size_t missing = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_keys; i++) {
+        RecordPointer value;
+        if (!tree.GetValue(keys[i], value) || value.record_id != keys[i]) missing++;
+    }
+    const double lookup_seconds = SecondsSince(start);
+
+    size_t scanned = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_scans; i++) {
+        for (RangeCursor cursor = tree.Scan(keys[i], keys[i] + 2 * SCAN_LENGTH); !cursor.IsEnd(); ++cursor) {
+            if (cursor.Value().record_id != cursor.Key()) missing++;
+            scanned++;
+        }
+    }
+    const double scan_seconds = SecondsSince(start);
+
+    std::printf("%4d byte nodes, fanout %3d: insert %6.1f ns, lookup %6.1f ns, scan %5.2f ns/entry, %zu KB of nodes\n",
+                BPLUS_NODE_BYTES, MAX_FANOUT, insert_seconds * 1e9 / num_keys, lookup_seconds * 1e9 / num_keys,
+                scanned == 0 ? 0.0 : scan_seconds * 1e9 / scanned, tree.MemoryUsage() / 1024);
+    if (missing != 0) {
+        std::printf("FAILED: %zu keys were missing or had the wrong value\n", missing);
+        return 1;
+    }
+    return 0;
+}
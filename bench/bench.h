@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * Benchmarks of executor_bench. Each one is run as
+ * `executor_bench <name> [options]` and returns the exit code of the run,
+ * non-zero when a result check failed.
+ */
+int RadixHashJoinBench(int argc, char **argv);
+int ConcurrentBPlusTreeBench(int argc, char **argv);
+
+/** @return the seconds elapsed since start */
+inline double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Read a numeric option given as `--name value`.
+ * @return the value, or default_value if the option is not given
+ */
+inline size_t SizeOption(int argc, char **argv, const char *name, size_t default_value) {
+    for (int i = 0; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], name) == 0) return std::strtoul(argv[i + 1], NULL, 10);
+    }
+    return default_value;
+}
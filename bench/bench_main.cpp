@@ -0,0 +1,34 @@
+#include <cstdio>
+#include <cstring>
+
+#include "bench.h"
+
+namespace {
+
+struct Bench {
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *description;
+};
+
+const Bench BENCHES[] = {
+    {"radix_hash_join", RadixHashJoinBench,
+     "RadixHashJoinExecutor against HashJoinExecutor [--left N] [--right N]"},
+    {"concurrent_b_plus_tree", ConcurrentBPlusTreeBench,
+     "ConcurrentBPlusTree stress test and 1-64 thread throughput [--max-threads N] [--threads N] [--ops N]"},
+};
+
+const size_t NUM_BENCHES = sizeof(BENCHES) / sizeof(BENCHES[0]);
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    for (size_t i = 0; argc > 1 && i < NUM_BENCHES; i++) {
+        if (std::strcmp(argv[1], BENCHES[i].name) == 0) return BENCHES[i].run(argc - 2, argv + 2);
+    }
+    std::printf("usage: %s <benchmark> [options]\n", argv[0]);
+    for (size_t i = 0; i < NUM_BENCHES; i++) {
+        std::printf("  %-24s %s\n", BENCHES[i].name, BENCHES[i].description);
+    }
+    return 2;
+}
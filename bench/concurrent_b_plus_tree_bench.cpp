@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "concurrent_b_plus_tree.h"
+
+namespace {
+
+// Keys below STABLE_KEYS: the even ones are inserted before the threads start and never removed
+const int STABLE_KEYS = 20000;
+// Each thread inserts and removes keys of its own above STABLE_KEYS
+const int KEYS_PER_THREAD = 50000;
+
+/*
+ * One stress thread: inserts and removes keys only it uses, looks up stable
+ * keys and scans ranges of them while the others split leaves around them.
+ * @return the number of wrong results seen
+ */
+int stress(ConcurrentBPlusTree *tree, int thread, int num_threads, size_t ops, std::set<int> *own) {
+    std::mt19937 rng(thread);
+    int errors = 0;
+    for (size_t i = 0; i < ops; i++) {
+        const int op = rng() % 4;
+        const int key = STABLE_KEYS + (int)(rng() % KEYS_PER_THREAD) * num_threads + thread;
+        if (op < 2) {
+            // the tree must agree with what this thread inserted before
+            const bool inserted = tree->Insert(key, RecordPointer(1, key));
+            if (inserted != own->insert(key).second) errors++;
+        } else if (op == 2) {
+            if (own->empty()) continue;
+            std::set<int>::iterator it = own->lower_bound(key);
+            if (it == own->end()) it = own->begin();
+            if (!tree->Remove(*it)) errors++;
+            own->erase(it);
+        } else if (i % 64 != 0) {
+            const int stable = (int)(rng() % (STABLE_KEYS / 2)) * 2;
+            RecordPointer value;
+            if (!tree->GetValue(stable, value) || value.record_id != stable) errors++;
+        } else {
+            // a range of stable keys holds exactly its even keys, in order, whatever else changes
+            const int from = (int)(rng() % (STABLE_KEYS / 2 - 500)) * 2;
+            std::vector<RecordPointer> values;
+            tree->RangeScan(from, from + 1000, values);
+            int prev = INT_MIN, stable = 0;
+            for (size_t v = 0; v < values.size(); v++) {
+                if (values[v].record_id <= prev) errors++;
+                prev = values[v].record_id;
+                if (values[v].page_id == 0) stable++;
+            }
+            if (stable != 500) errors++;
+        }
+    }
+    return errors;
+}
+
+/*
+ * Runs the stress threads, then checks that the tree holds exactly the stable
+ * keys and the keys each thread left inserted.
+ * @return the number of wrong results seen
+ */
+int stressTest(int num_threads, size_t ops) {
+    ConcurrentBPlusTree tree;
+    for (int key = 0; key < STABLE_KEYS; key += 2) tree.Insert(key, RecordPointer(0, key));
+
+    std::vector<std::set<int>> own(num_threads);
+    std::vector<int> errors(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&tree, &own, &errors, t, num_threads, ops] {
+            errors[t] = stress(&tree, t, num_threads, ops, &own[t]);
+        });
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    int failed = 0;
+    for (int t = 0; t < num_threads; t++) failed += errors[t];
+    std::set<int> expected;
+    for (int key = 0; key < STABLE_KEYS; key += 2) expected.insert(key);
+    for (int t = 0; t < num_threads; t++) expected.insert(own[t].begin(), own[t].end());
+
+    std::vector<RecordPointer> values;
+    tree.RangeScan(INT_MIN, INT_MAX, values);
+    if (values.size() != expected.size()) failed++;
+    size_t v = 0;
+    for (std::set<int>::iterator it = expected.begin(); it != expected.end(); ++it, v++) {
+        RecordPointer value;
+        if (!tree.GetValue(*it, value) || value.record_id != *it) failed++;
+        if (v < values.size() && values[v].record_id != *it) failed++;
+    }
+    std::printf("stress: %d threads, %zu ops each, %zu keys left, %d errors\n", num_threads, ops, expected.size(),
+                failed);
+    return failed;
+}
+
+/*
+ * Measures num_threads threads doing 1 insert for every 3 lookups of random
+ * keys, then checks that the tree holds every key an insert reported as new.
+ * @return million operations per second, or a negative value if keys were lost
+ */
+double throughput(int num_threads, size_t total_ops) {
+    ConcurrentBPlusTree tree;
+    const size_t ops = total_ops / num_threads;
+    std::vector<size_t> inserted(num_threads, 0);
+    std::vector<std::thread> threads;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&tree, &inserted, t, ops] {
+            std::mt19937 rng(t);
+            for (size_t i = 0; i < ops; i++) {
+                const int key = (int)(rng() % 1000000);
+                RecordPointer value;
+                if (i % 4 == 0) {
+                    if (tree.Insert(key, RecordPointer(0, key))) inserted[t]++;
+                } else {
+                    tree.GetValue(key, value);
+                }
+            }
+        });
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    const double seconds = SecondsSince(start);
+
+    size_t expected = 0;
+    for (int t = 0; t < num_threads; t++) expected += inserted[t];
+    std::vector<RecordPointer> values;
+    tree.RangeScan(INT_MIN, INT_MAX, values);
+    bool sorted = true;
+    for (size_t v = 1; v < values.size(); v++) {
+        if (values[v].record_id <= values[v - 1].record_id) sorted = false;
+    }
+    if (!sorted || values.size() != expected) return -1;
+    return ops * num_threads / seconds / 1e6;
+}
+
+}  // namespace
+
+/*
+ * Stress test of ConcurrentBPlusTree at the top of the thread sweep, followed
+ * by its throughput from 1 to --max-threads threads. Fails if the stress test
+ * saw a wrong result or wrong final contents, or if a throughput run lost keys.
+ */
+int ConcurrentBPlusTreeBench(int argc, char **argv) {
+    const size_t max_threads = std::max<size_t>(SizeOption(argc, argv, "--max-threads", 64), 1);
+    const int stress_threads = (int)std::max<size_t>(SizeOption(argc, argv, "--threads", max_threads), 1);
+    const size_t stress_ops = SizeOption(argc, argv, "--ops", 20000);
+    const size_t sweep_ops = SizeOption(argc, argv, "--sweep-ops", 2000000);
+
+    int failed = stressTest(stress_threads, stress_ops);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        const double mops = throughput((int)threads, sweep_ops);
+        if (mops < 0) {
+            std::printf("throughput: %2zu threads lost inserted keys\n", threads);
+            failed++;
+        } else {
+            std::printf("throughput: %2zu threads %8.2f Mops/s\n", threads, mops);
+        }
+    }
+    return failed != 0;
+}
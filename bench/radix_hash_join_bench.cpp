@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "hash_join_executor.h"
+#include "radix_hash_join_executor.h"
+#include "seq_scan_executor.h"
+
+namespace {
+
+// Runs a join to completion, returning the number of tuples and a checksum of their ids
+void drain(AbstractExecutor *join, size_t *count, long long *checksum) {
+    join->Init();
+    Tuple tuple;
+    *count = 0;
+    *checksum = 0;
+    while (join->Next(&tuple)) {
+        (*count)++;
+        *checksum += tuple.id;
+    }
+}
+
+}  // namespace
+
+/*
+ * Joins a left table of unique ids with a right table of random ids on "id",
+ * with HashJoinExecutor on a SimpleHashJoinHashTable and with
+ * RadixHashJoinExecutor in one and two partitioning passes.
+ */
+int RadixHashJoinBench(int argc, char **argv) {
+    const size_t num_left = SizeOption(argc, argv, "--left", 2000000);
+    const size_t num_right = SizeOption(argc, argv, "--right", 4000000);
+
+    std::mt19937 rng(42);
+    Table left, right;
+    for (size_t i = 0; i < num_left; i++) left.insert((int)i, (int)(rng() % 1000), "");
+    for (size_t i = 0; i < num_right; i++) right.insert((int)(rng() % num_left), (int)(rng() % 1000), "");
+    SimpleHashFunction hash_fn("id");
+
+    size_t ref_count;
+    long long ref_checksum;
+    {
+        SeqScanExecutor left_scan(&left), right_scan(&right);
+        HashJoinExecutor join(&left_scan, &right_scan, &hash_fn);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        drain(&join, &ref_count, &ref_checksum);
+        std::printf("%-28s %8.1f ms  %zu tuples\n", "HashJoinExecutor", SecondsSince(start) * 1000, ref_count);
+    }
+
+    int failed = 0;
+    for (int passes = 1; passes <= 2; passes++) {
+        SeqScanExecutor left_scan(&left), right_scan(&right);
+        RadixHashJoinExecutor join(&left_scan, &right_scan, &hash_fn, 0, passes);
+        size_t count;
+        long long checksum;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        drain(&join, &count, &checksum);
+        const bool same = count == ref_count && checksum == ref_checksum;
+        std::printf("RadixHashJoinExecutor %d pass %8.1f ms  %zu tuples%s\n", passes, SecondsSince(start) * 1000,
+                    count, same ? "" : "  MISMATCH");
+        if (!same) failed = 1;
+    }
+    return failed;
+}
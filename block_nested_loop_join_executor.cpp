@@ -0,0 +1,78 @@
+#include "../include/block_nested_loop_join_executor.h"
+
+BlockNestedLoopJoinExecutor::BlockNestedLoopJoinExecutor(
+    AbstractExecutor *left_child_executor,
+    AbstractExecutor *right_child_executor, const std::string &join_key,
+    PredicateType condition, size_t block_bytes)
+    : left_(left_child_executor),
+      right_(right_child_executor),
+      column_(TupleColumn::ID),
+      valid_key_(ParseTupleColumn(join_key, &column_)),
+      condition_(condition),
+      block_bytes_(block_bytes),
+      outer_pos_(0),
+      inner_(NULL),
+      rescan_inner_(false) {}
+
+void BlockNestedLoopJoinExecutor::Init() {
+    outer_block_.clear();
+    outer_pos_ = 0;
+    inner_ = NULL;
+    rescan_inner_ = false;
+    left_->Init();
+    right_->Init();
+}
+
+bool BlockNestedLoopJoinExecutor::matches(const Tuple &inner_tuple, const Tuple &outer_tuple) const {
+    int cmp = CompareKeys(inner_tuple, outer_tuple, column_);
+    switch (condition_) {
+        case PredicateType::GREATER:
+            return cmp > 0;
+        case PredicateType::LESS:
+            return cmp < 0;
+        case PredicateType::EQUAL:
+            return cmp == 0;
+        default:
+            return false;
+    }
+}
+
+bool BlockNestedLoopJoinExecutor::fillOuterBlock() {
+    outer_block_.clear();
+    size_t bytes = 0;
+    // always take at least one tuple, even if it alone exceeds the budget
+    while (outer_block_.empty() || bytes < block_bytes_) {
+        outer_block_.emplace_back();
+        if (!right_->Next(&outer_block_.back())) {
+            outer_block_.pop_back();
+            break;
+        }
+        bytes += sizeof(Tuple) + outer_block_.back().val2.capacity();
+    }
+    return !outer_block_.empty();
+}
+
+bool BlockNestedLoopJoinExecutor::Next(Tuple *tuple) {
+    if (!valid_key_) return false;
+    for (;;) {
+        // compare the current inner tuple with the rest of the block
+        if (inner_ != NULL) {
+            while (outer_pos_ < outer_block_.size()) {
+                if (matches(*inner_, outer_block_[outer_pos_++])) {
+                    *tuple = *inner_;
+                    return true;
+                }
+            }
+            inner_ = NULL;
+        }
+        if (!outer_block_.empty() && left_->NextRef(&inner_)) {
+            outer_pos_ = 0;
+            continue;
+        }
+        inner_ = NULL;
+        // the inner table is exhausted for this block, move on to the next one
+        if (!fillOuterBlock()) return false;
+        if (rescan_inner_) left_->Init();
+        rescan_inner_ = true;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "filter_seq_scan_executor.h"
+#include "storage.h"
+#include "tuple_column.h"
+
+/** Default memory budget of a block of outer tuples, in bytes. */
+static const size_t DEFAULT_OUTER_BLOCK_BYTES = 4 * 1024 * 1024;
+
+/**
+ * BlockNestedLoopJoinExecutor joins the inner (left) and outer (right) tables
+ * like NestedLoopJoinExecutor, producing each inner tuple once per matching
+ * outer tuple, but buffers a block of outer tuples and scans the inner table
+ * once per block instead of once per outer tuple.
+ *
+ * Besides equality, the join condition can be any comparison of the inner
+ * key against the outer key, so the executor also serves as a fallback for
+ * non-equi joins that the hash and sort-merge joins cannot run.
+ * Output is ordered by block, then by inner tuple, then by outer tuple.
+ */
+class BlockNestedLoopJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new block nested loop join executor.
+   * @param left_child_executor the left child executor (inner table)
+   * @param right_child_executor the right child executor (outer table)
+   * @param join_key the attribute to join on, one of {"id","val1","val2"}
+   * @param condition how the inner key compares to the outer key, e.g.
+   *                  GREATER joins the inner tuples whose key is greater
+   * @param block_bytes memory budget of a block of outer tuples, in bytes
+   */
+  BlockNestedLoopJoinExecutor(AbstractExecutor *left_child_executor,
+                              AbstractExecutor *right_child_executor,
+                              const std::string &join_key,
+                              PredicateType condition = PredicateType::EQUAL,
+                              size_t block_bytes = DEFAULT_OUTER_BLOCK_BYTES);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from join.
+   * @param tuple the next inner tuple that matches an outer tuple
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+ private:
+  /**
+   * Read the next block of outer tuples.
+   * @return `true` if the block holds at least one tuple
+   */
+  bool fillOuterBlock();
+
+  /** @return `true` if the inner tuple satisfies the join condition with the outer tuple */
+  bool matches(const Tuple &inner_tuple, const Tuple &outer_tuple) const;
+
+  AbstractExecutor *left_;    ///< Pointer to the left child executor (inner table).
+  AbstractExecutor *right_;   ///< Pointer to the right child executor (outer table).
+  TupleColumn column_;        ///< Join key, resolved once in the constructor.
+  bool valid_key_;
+  PredicateType condition_;
+  size_t block_bytes_;
+
+  std::vector<Tuple> outer_block_;  ///< Current block of outer tuples.
+  size_t outer_pos_;                ///< Next outer tuple to compare with inner_.
+  const Tuple *inner_;              ///< Current inner tuple, NULL between inner tuples.
+  bool rescan_inner_;               ///< Whether the inner table must be re-initiated for the next block.
+};
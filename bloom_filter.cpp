@@ -0,0 +1,30 @@
+#include "../include/bloom_filter.h"
+
+#include <cstring>
+#include <new>
+
+namespace {
+
+// About 10 bits per key, ~1% false positives for 4 bits set per key
+const size_t KEYS_PER_BLOCK = 50;
+// mix() leaves 24 bits above bit 40 to pick a block
+const size_t MAX_BLOCKS = (size_t)1 << 24;
+const size_t CACHE_LINE_BYTES = 64;
+
+}  // namespace
+
+void BlockedBloomFilter::Reset(size_t expected_keys) {
+    size_t num_blocks = 1;
+    while (num_blocks * KEYS_PER_BLOCK < expected_keys && num_blocks < MAX_BLOCKS) num_blocks *= 2;
+    const size_t bytes = num_blocks * WORDS_PER_BLOCK * sizeof(uint64_t);
+    // keep the blocks when the size does not change
+    if (words_ == NULL || num_blocks != block_mask_ + 1) {
+        std::free(words_);
+        words_ = NULL;
+        void *blocks;
+        if (posix_memalign(&blocks, CACHE_LINE_BYTES, bytes) != 0) throw std::bad_alloc();
+        words_ = static_cast<uint64_t *>(blocks);
+    }
+    block_mask_ = num_blocks - 1;
+    std::memset(words_, 0, bytes);
+}
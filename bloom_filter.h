@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+using hash_t = unsigned int;
+
+/**
+ * A blocked Bloom filter over join-key hashes.
+ * Every key sets a few bits within one 64-byte block, and blocks start on a
+ * cache line boundary, so a lookup touches a single cache line. It has no false negatives: a hash that
+ * was inserted always passes MayContain().
+ */
+class BlockedBloomFilter {
+ public:
+  BlockedBloomFilter() : words_(NULL), block_mask_(0) { Reset(0); }
+  ~BlockedBloomFilter() { std::free(words_); }
+
+  BlockedBloomFilter(const BlockedBloomFilter &) = delete;
+  BlockedBloomFilter &operator=(const BlockedBloomFilter &) = delete;
+
+  /**
+   * Drop all keys and size the filter for a number of keys.
+   * @param expected_keys the number of keys that will be inserted
+   */
+  void Reset(size_t expected_keys);
+
+  /** Add a hash to the filter. */
+  void Insert(hash_t h) {
+    const uint64_t mixed = mix(h);
+    uint64_t *block = words_ + blockOf(mixed) * WORDS_PER_BLOCK;
+    for (int i = 0; i < BITS_PER_KEY; i++) {
+      const unsigned bit = (mixed >> (9 * i)) & 511;
+      block[bit >> 6] |= (uint64_t)1 << (bit & 63);
+    }
+  }
+
+  /** @return `false` if h was certainly never inserted, `true` if it may have been */
+  bool MayContain(hash_t h) const {
+    const uint64_t mixed = mix(h);
+    const uint64_t *block = words_ + blockOf(mixed) * WORDS_PER_BLOCK;
+    bool found = true;
+    for (int i = 0; i < BITS_PER_KEY; i++) {
+      const unsigned bit = (mixed >> (9 * i)) & 511;
+      found &= (block[bit >> 6] >> (bit & 63)) & 1;
+    }
+    return found;
+  }
+
+ private:
+  static const int WORDS_PER_BLOCK = 8;  // 512 bits, one cache line
+  static const int BITS_PER_KEY = 4;
+
+  // Spread the hash over 64 bits: the low 36 bits pick the bits within a
+  // block, the high bits pick the block
+  static uint64_t mix(hash_t h) { return (uint64_t)h * 0x9E3779B97F4A7C15ull; }
+  size_t blockOf(uint64_t mixed) const { return (size_t)(mixed >> 40) & block_mask_; }
+
+  uint64_t *words_;  ///< The blocks, allocated on a cache line boundary
+  size_t block_mask_;
+};
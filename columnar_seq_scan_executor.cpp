@@ -0,0 +1,55 @@
+#include "../include/columnar_seq_scan_executor.h"
+
+#include <algorithm>
+
+#include "../include/filter_kernel.h"
+
+ColumnarSeqScanExecutor::ColumnarSeqScanExecutor(ColumnarTable *table,
+                                                 FilterPredicate *predicate,
+                                                 bool with_val2)
+    : table_(table),
+      pred_(predicate),
+      with_val2_(with_val2),
+      row_(0),
+      selection_(FILTER_BLOCK_SIZE){};
+
+void ColumnarSeqScanExecutor::Init() { row_ = 0; }
+
+bool ColumnarSeqScanExecutor::Next(Tuple *tuple) {
+  const int *val1s = table_->Val1Column();
+  const size_t num_rows = table_->Size();
+  while (row_ < num_rows) {
+    const size_t row = row_++;
+    if (pred_ == NULL || PredicateMatches(val1s[row], pred_->val, pred_->condition)) {
+      table_->Materialize(row, tuple, with_val2_);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ColumnarSeqScanExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  const size_t num_rows = table_->Size();
+  if (pred_ == NULL) {
+    for (; row_ < num_rows && !batch->IsFull(); ++row_) {
+      table_->Materialize(row_, batch->Slot(), with_val2_);
+      batch->Commit();
+    }
+    return !batch->IsEmpty();
+  }
+  // Filter the val1 column in place; a block never selects more rows than
+  // there is room left in the batch
+  const int *val1s = table_->Val1Column();
+  while (row_ < num_rows && !batch->IsFull()) {
+    const size_t rows = std::min(std::min(batch->Capacity() - batch->Size(), FILTER_BLOCK_SIZE),
+                                 num_rows - row_);
+    const size_t selected = SelectVal1(val1s + row_, rows, pred_->val, pred_->condition, selection_.data());
+    for (size_t i = 0; i < selected; i++) {
+      table_->Materialize(row_ + selection_[i], batch->Slot(), with_val2_);
+      batch->Commit();
+    }
+    row_ += rows;
+  }
+  return !batch->IsEmpty();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "columnar_storage.h"
+#include "filter_seq_scan_executor.h"
+
+/**
+ * The ColumnarSeqScanExecutor executes a sequential scan over a ColumnarTable.
+ * An optional predicate is evaluated directly on the contiguous val1 column
+ * (with the vectorized filter kernel in NextBatch), and only rows that pass
+ * are assembled into tuples.
+ */
+class ColumnarSeqScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new columnar scan.
+   * @param table the columnar table to scan
+   * @param predicate optional filter on val1, NULL to produce every row
+   * @param with_val2 if false, the val2 column is never read and produced
+   *                  tuples carry an empty val2 (for filters and aggregates)
+   */
+  ColumnarSeqScanExecutor(ColumnarTable *table, FilterPredicate *predicate = NULL,
+                          bool with_val2 = true);
+
+  /** Initialize the columnar scan */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the columnar scan.
+   * @param tuple the next tuple produced by scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /**
+   * Yield the next batch of tuples from the columnar scan.
+   * @param batch the batch to fill with the next qualifying rows
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+ private:
+  ColumnarTable *table_;
+  FilterPredicate *pred_;
+  bool with_val2_;
+  size_t row_;
+  std::vector<uint32_t> selection_;  ///< Selection vector of the current block
+};
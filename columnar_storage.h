@@ -0,0 +1,70 @@
+/**
+ * Column-oriented (struct of arrays) variant of the mocked storage Table.
+ * id and val1 live in contiguous int arrays and val2 in a separate string
+ * column, so scans that only look at val1 never touch the string payload.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "storage.h"
+
+class ColumnarTable {
+ public:
+  ColumnarTable(){};
+
+  /** Build a columnar copy of a row-oriented table. */
+  explicit ColumnarTable(Table *table) {
+    for (std::vector<Tuple>::iterator it = table->Begin(); it != table->End(); ++it) {
+      insert(it->id, it->val1, it->val2);
+    }
+  }
+
+  bool insert(const Tuple &tuple) { return insert(tuple.id, tuple.val1, tuple.val2); }
+
+  bool insert(int id, int val1, std::string val2) {
+    ids_.push_back(id);
+    val1s_.push_back(val1);
+    val2s_.push_back(val2);
+    return true;
+  }
+
+  /** Reserve space for num_rows rows in every column. */
+  void Reserve(size_t num_rows) {
+    ids_.reserve(num_rows);
+    val1s_.reserve(num_rows);
+    val2s_.reserve(num_rows);
+  }
+
+  /** @return the number of rows in the table */
+  size_t Size() const { return ids_.size(); }
+
+  /** Contiguous column arrays, each Size() entries long. */
+  const int *IdColumn() const { return ids_.data(); }
+  const int *Val1Column() const { return val1s_.data(); }
+  const std::string *Val2Column() const { return val2s_.data(); }
+
+  /**
+   * Assemble the row at position row into a tuple.
+   * @param row position of the row, must be smaller than Size()
+   * @param[out] tuple the tuple to write the row into
+   * @param with_val2 if false, the val2 column is not read and val2 is cleared
+   */
+  void Materialize(size_t row, Tuple *tuple, bool with_val2 = true) const {
+    tuple->id = ids_[row];
+    tuple->val1 = val1s_[row];
+    if (with_val2) {
+      tuple->val2 = val2s_[row];
+    } else {
+      tuple->val2.clear();
+    }
+  }
+
+ private:
+  std::vector<int> ids_;
+  std::vector<int> val1s_;
+  std::vector<std::string> val2s_;
+};
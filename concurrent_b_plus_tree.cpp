@@ -0,0 +1,388 @@
+#include "../include/concurrent_b_plus_tree.h"
+#include "../include/node_search.h"
+#include <cstring>
+#include <thread>
+
+/*****************************************************************************
+ * VERSION LATCH
+ *****************************************************************************/
+// A version is even while nobody writes the node. Writers add 1 when latching
+// and 1 again when releasing, so it is odd while latched and any write changes
+// it. Nodes are never freed while the tree is in use, so unlike the usual
+// optimistic lock coupling there is no obsolete state for a reader to check.
+static const uint64_t VERSION_LOCKED = 1;
+
+// Backs off after a failed optimistic attempt, yielding once contention lasts
+static void backOff(int restartCount)
+{
+    if (restartCount > 3) {
+        std::this_thread::yield();
+    }
+}
+
+// Waits for the node to be unlocked and returns its version
+static uint64_t stableVersion(const ConcurrentNode *node)
+{
+    uint64_t version = node->version.load(std::memory_order_acquire);
+    while ((version & VERSION_LOCKED) == VERSION_LOCKED) {
+        std::this_thread::yield();
+        version = node->version.load(std::memory_order_acquire);
+    }
+    return version;
+}
+
+// Checks that the node has not changed since version was read
+static void checkOrRestart(const ConcurrentNode *node, uint64_t version, bool &needRestart)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (node->version.load(std::memory_order_relaxed) != version) {
+        needRestart = true;
+    }
+}
+
+// Latches the node for writing if it has not changed since version was read
+static void upgradeToWriteLockOrRestart(ConcurrentNode *node, uint64_t version, bool &needRestart)
+{
+    if (!node->version.compare_exchange_strong(version, version + VERSION_LOCKED, std::memory_order_acquire)) {
+        needRestart = true;
+    }
+}
+
+static void writeUnlock(ConcurrentNode *node)
+{
+    node->version.fetch_add(VERSION_LOCKED, std::memory_order_release);
+}
+
+/*****************************************************************************
+ * NODE OPERATIONS
+ *****************************************************************************/
+// Inserts an entry into the first count entries of a node array
+template <typename T>
+static void insertEntryAt(T *entries, int count, int pos, const T &entry)
+{
+    memmove(entries + pos + 1, entries + pos, (count - pos) * sizeof(T));
+    entries[pos] = entry;
+}
+
+/**
+ * Moves the upper half of a full leaf node to an empty one linked after it
+ * @return The first key of the new leaf node, its separator in the parent
+ */
+static KeyType splitLeafNode(ConcurrentLeafNode *leaf, ConcurrentLeafNode *newLeaf)
+{
+    int leftCount = leaf->key_num - leaf->key_num / 2;
+    newLeaf->key_num = leaf->key_num - leftCount;
+    memcpy(newLeaf->keys, leaf->keys + leftCount, newLeaf->key_num * sizeof(KeyType));
+    memcpy(newLeaf->pointers, leaf->pointers + leftCount, newLeaf->key_num * sizeof(RecordPointer));
+    leaf->key_num = leftCount;
+
+    // only the writer holding this leaf links after it, so prev_leaf of the next leaf is ours to set
+    newLeaf->next_leaf = leaf->next_leaf;
+    newLeaf->prev_leaf = leaf;
+    if (newLeaf->next_leaf != NULL) {
+        newLeaf->next_leaf->prev_leaf = newLeaf;
+    }
+    leaf->next_leaf = newLeaf;
+    return newLeaf->keys[0];
+}
+
+/**
+ * Moves the keys and children after the middle key of a full internal node to an empty one
+ * @return The middle key, which moves up to the parent
+ */
+static KeyType splitInternalNode(ConcurrentInternalNode *node, ConcurrentInternalNode *newNode)
+{
+    int leftKeys = node->key_num / 2;
+    KeyType middleKey = node->keys[leftKeys];
+    newNode->key_num = node->key_num - leftKeys - 1;
+    memcpy(newNode->keys, node->keys + leftKeys + 1, newNode->key_num * sizeof(KeyType));
+    memcpy(newNode->children, node->children + leftKeys + 1, (newNode->key_num + 1) * sizeof(ConcurrentNode *));
+    node->key_num = leftKeys;
+    return middleKey;
+}
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+ConcurrentBPlusTree::ConcurrentBPlusTree()
+{
+    // the root always exists, an empty tree is an empty leaf
+    root.store(newLeafNode());
+}
+
+ConcurrentBPlusTree::~ConcurrentBPlusTree()
+{
+    leaf_pool.Reset();
+    internal_pool.Reset();
+}
+
+ConcurrentLeafNode *ConcurrentBPlusTree::newLeafNode()
+{
+    std::lock_guard<std::mutex> guard(pool_mutex);
+    return leaf_pool.Allocate();
+}
+
+ConcurrentInternalNode *ConcurrentBPlusTree::newInternalNode()
+{
+    std::lock_guard<std::mutex> guard(pool_mutex);
+    return internal_pool.Allocate();
+}
+
+size_t ConcurrentBPlusTree::MemoryUsage() const
+{
+    std::lock_guard<std::mutex> guard(pool_mutex);
+    return leaf_pool.MemoryUsage() + internal_pool.MemoryUsage();
+}
+
+void ConcurrentBPlusTree::makeRoot(const KeyType &keyTp, ConcurrentNode *leftNode, ConcurrentNode *rightNode)
+{
+    ConcurrentInternalNode *newRoot = newInternalNode();
+    newRoot->key_num = 1;
+    newRoot->keys[0] = keyTp;
+    newRoot->children[0] = leftNode;
+    newRoot->children[1] = rightNode;
+    root.store(newRoot, std::memory_order_release);
+}
+
+/*
+ * Descends to the leaf node that may hold keyTp. Each child pointer is only
+ * followed once the version of its node confirms it was read consistently.
+ * @return The leaf node and, through leafVersion, its version; needRestart
+ *         is set if a node changed on the way
+ */
+ConcurrentLeafNode *ConcurrentBPlusTree::findLeafNode(const KeyType &keyTp, uint64_t &leafVersion, bool &needRestart) const
+{
+    ConcurrentNode *node = root.load(std::memory_order_acquire);
+    uint64_t versionNode = stableVersion(node);
+    if (node != root.load(std::memory_order_acquire)) {
+        needRestart = true;
+        return NULL;
+    }
+    uint64_t versionInner = versionNode;
+    while (!node->is_leaf) {
+        ConcurrentInternalNode *inner = (ConcurrentInternalNode *)node;
+        ConcurrentNode *child = inner->children[NodeUpperBound(inner->keys, inner->key_num, keyTp)];
+        PrefetchNodeKeys(child);
+        checkOrRestart(inner, versionInner, needRestart);
+        if (needRestart) return NULL;
+        node = child;
+        versionNode = stableVersion(node);
+        // the child may have split before its version was read, the parent would show it
+        checkOrRestart(inner, versionInner, needRestart);
+        if (needRestart) return NULL;
+        versionInner = versionNode;
+    }
+    leafVersion = versionNode;
+    return (ConcurrentLeafNode *)node;
+}
+
+/*
+ * Insert constant key & value pair into the tree
+ * On the way down, a full internal node is split under the latches of itself
+ * and its parent, then the insert restarts. A full leaf is split the same
+ * way; otherwise only the leaf is latched.
+ * @return: false for a duplicate key, otherwise true
+ */
+bool ConcurrentBPlusTree::Insert(const KeyType &key, const RecordPointer &value)
+{
+    for (int restartCount = 0;; restartCount++) {
+        backOff(restartCount);
+        bool needRestart = false;
+        ConcurrentNode *node = root.load(std::memory_order_acquire);
+        uint64_t versionNode = stableVersion(node);
+        if (node != root.load(std::memory_order_acquire)) continue;
+
+        ConcurrentInternalNode *parent = NULL;
+        uint64_t versionParent = 0;
+        int childIndex = 0;
+
+        while (!needRestart) {
+            bool full = node->key_num == MAX_FANOUT - 1;
+            if (full) {
+                // latch the parent and the node, then split the node
+                if (parent != NULL) {
+                    upgradeToWriteLockOrRestart(parent, versionParent, needRestart);
+                    if (needRestart) break;
+                }
+                upgradeToWriteLockOrRestart(node, versionNode, needRestart);
+                if (needRestart) {
+                    if (parent != NULL) writeUnlock(parent);
+                    break;
+                }
+                if (parent == NULL && node != root.load(std::memory_order_acquire)) {
+                    // another thread grew the tree above this node
+                    writeUnlock(node);
+                    needRestart = true;
+                    break;
+                }
+                KeyType separator;
+                ConcurrentNode *newNode;
+                if (node->is_leaf) {
+                    ConcurrentLeafNode *newLeaf = newLeafNode();
+                    separator = splitLeafNode((ConcurrentLeafNode *)node, newLeaf);
+                    newNode = newLeaf;
+                } else {
+                    ConcurrentInternalNode *newInner = newInternalNode();
+                    separator = splitInternalNode((ConcurrentInternalNode *)node, newInner);
+                    newNode = newInner;
+                }
+                if (parent != NULL) {
+                    // the parent was not full when we passed it, so it has room
+                    insertEntryAt(parent->keys, parent->key_num, childIndex, separator);
+                    insertEntryAt(parent->children, parent->key_num + 1, childIndex + 1, newNode);
+                    parent->key_num++;
+                } else {
+                    makeRoot(separator, node, newNode);
+                }
+                writeUnlock(node);
+                if (parent != NULL) writeUnlock(parent);
+                needRestart = true;
+                break;
+            }
+
+            if (node->is_leaf) break;
+
+            // the node has room, so the parent is no longer needed
+            if (parent != NULL) {
+                checkOrRestart(parent, versionParent, needRestart);
+                if (needRestart) break;
+            }
+            ConcurrentInternalNode *inner = (ConcurrentInternalNode *)node;
+            childIndex = NodeUpperBound(inner->keys, inner->key_num, key);
+            ConcurrentNode *child = inner->children[childIndex];
+            PrefetchNodeKeys(child);
+            checkOrRestart(inner, versionNode, needRestart);
+            if (needRestart) break;
+            parent = inner;
+            versionParent = versionNode;
+            node = child;
+            versionNode = stableVersion(node);
+        }
+        if (needRestart) continue;
+
+        // a leaf with room: latch only the leaf
+        ConcurrentLeafNode *leaf = (ConcurrentLeafNode *)node;
+        upgradeToWriteLockOrRestart(leaf, versionNode, needRestart);
+        if (needRestart) continue;
+        if (parent != NULL) {
+            checkOrRestart(parent, versionParent, needRestart);
+            if (needRestart) {
+                writeUnlock(leaf);
+                continue;
+            }
+        }
+        int index = NodeLowerBound(leaf->keys, leaf->key_num, key);
+        bool duplicate = index < leaf->key_num && leaf->keys[index] == key;
+        if (!duplicate) {
+            insertEntryAt(leaf->keys, leaf->key_num, index, key);
+            insertEntryAt(leaf->pointers, leaf->key_num, index, value);
+            leaf->key_num++;
+        }
+        writeUnlock(leaf);
+        return !duplicate;
+    }
+}
+
+/*
+ * Delete keyTp & value pair associated with input keyTp
+ * Only the leaf is latched. Underfull and empty nodes stay in the tree, so
+ * no node is ever freed under a concurrent reader.
+ * @return: true if the key was present
+ */
+bool ConcurrentBPlusTree::Remove(const KeyType &keyTp)
+{
+    for (int restartCount = 0;; restartCount++) {
+        backOff(restartCount);
+        bool needRestart = false;
+        uint64_t versionLeaf;
+        ConcurrentLeafNode *leaf = findLeafNode(keyTp, versionLeaf, needRestart);
+        if (needRestart) continue;
+        upgradeToWriteLockOrRestart(leaf, versionLeaf, needRestart);
+        if (needRestart) continue;
+
+        int index = NodeLowerBound(leaf->keys, leaf->key_num, keyTp);
+        bool found = index < leaf->key_num && leaf->keys[index] == keyTp;
+        if (found) {
+            memmove(leaf->keys + index, leaf->keys + index + 1, (leaf->key_num - index - 1) * sizeof(KeyType));
+            memmove(leaf->pointers + index, leaf->pointers + index + 1, (leaf->key_num - index - 1) * sizeof(RecordPointer));
+            leaf->key_num--;
+        }
+        writeUnlock(leaf);
+        return found;
+    }
+}
+
+/*
+ * Return the only value that associated with input keyTp
+ * This method never latches, it retries if a writer got in the way
+ * @return : true means keyTp exists
+ */
+bool ConcurrentBPlusTree::GetValue(const KeyType &keyTp, RecordPointer &result) const
+{
+    for (int restartCount = 0;; restartCount++) {
+        backOff(restartCount);
+        bool needRestart = false;
+        uint64_t versionLeaf;
+        ConcurrentLeafNode *leaf = findLeafNode(keyTp, versionLeaf, needRestart);
+        if (needRestart) continue;
+
+        int index = NodeLowerBound(leaf->keys, leaf->key_num, keyTp);
+        bool found = index < leaf->key_num && leaf->keys[index] == keyTp;
+        RecordPointer value;
+        if (found) value = leaf->pointers[index];
+        checkOrRestart(leaf, versionLeaf, needRestart);
+        if (needRestart) continue;
+        if (found) result = value;
+        return found;
+    }
+}
+
+/*
+ * Return the values that within the given key range
+ * Each leaf is copied optimistically and validated before its values are
+ * kept. If a leaf changed, the scan descends again from the last key kept.
+ */
+void ConcurrentBPlusTree::RangeScan(const KeyType &key_start, const KeyType &key_end,
+                                    std::vector<RecordPointer> &result) const
+{
+    KeyType fromKey = key_start;
+    bool afterFromKey = false;  // whether fromKey itself was already kept
+    for (int restartCount = 0;; restartCount++) {
+        backOff(restartCount);
+        bool needRestart = false;
+        uint64_t versionLeaf;
+        ConcurrentLeafNode *leaf = findLeafNode(fromKey, versionLeaf, needRestart);
+        if (needRestart) continue;
+
+        while (true) {
+            // the following leaf loads while this one is read, a stale pointer is harmless
+            ConcurrentLeafNode *ahead = leaf->next_leaf;
+            if (ahead != NULL) PrefetchNodeKeys(ahead);
+            size_t kept = result.size();
+            int index = afterFromKey ? NodeUpperBound(leaf->keys, leaf->key_num, fromKey)
+                                     : NodeLowerBound(leaf->keys, leaf->key_num, fromKey);
+            bool pastEnd = false;
+            for (; index < leaf->key_num; index++) {
+                if (!(leaf->keys[index] < key_end)) {
+                    pastEnd = true;
+                    break;
+                }
+                result.push_back(leaf->pointers[index]);
+            }
+            KeyType lastKey = result.size() > kept ? leaf->keys[index - 1] : fromKey;
+            ConcurrentLeafNode *next = leaf->next_leaf;
+            checkOrRestart(leaf, versionLeaf, needRestart);
+            if (needRestart) {
+                result.resize(kept);
+                break;
+            }
+            if (result.size() > kept) {
+                fromKey = lastKey;
+                afterFromKey = true;
+            }
+            if (pastEnd || next == NULL) return;
+            leaf = next;
+            versionLeaf = stableVersion(leaf);
+        }
+    }
+}
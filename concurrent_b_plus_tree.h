@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "b_plus_tree.h"
+#include "node_pool.h"
+
+// Header of a ConcurrentBPlusTree node: the BPlusTree header plus the version
+// latch. A version is even while the node is unlatched; see
+// concurrent_b_plus_tree.cpp.
+struct LatchedNodeHeader : public NodeHeader
+{
+    LatchedNodeHeader(bool leaf) : NodeHeader(leaf), version(0){};
+    std::atomic<uint64_t> version;
+};
+
+// The nodes of ConcurrentBPlusTree have the fanout of BPlusTree nodes, so the
+// latch makes them 8 bytes larger than BPLUS_NODE_BYTES allows for
+typedef BasicNode<LatchedNodeHeader> ConcurrentNode;
+typedef BasicInternalNode<LatchedNodeHeader> ConcurrentInternalNode;
+typedef BasicLeafNode<LatchedNodeHeader> ConcurrentLeafNode;
+
+/**
+ * Thread-safe B+ tree using optimistic lock coupling.
+ *
+ * It stores the same node layout as BPlusTree, with a version latch added
+ * to each node header. Readers never take a latch. They remember the version of each
+ * node they pass and check it again before trusting what they read; if it
+ * changed, they restart from the root. Writers latch only the nodes they
+ * modify: the leaf, plus the parent when a node splits.
+ *
+ * Full nodes are split on the way down, so a split never has to reach
+ * further up than the parent. Remove takes the key out of its leaf without
+ * merging nodes. Nodes are therefore never freed while the tree is in use,
+ * and a reader can always dereference a node it has reached. All nodes are
+ * released together by the destructor.
+ * (1) We only support UNIQUE key
+ * (2) Insert, Remove, GetValue and RangeScan may be called from any thread
+ */
+class ConcurrentBPlusTree
+{
+public:
+    ConcurrentBPlusTree();
+
+    ~ConcurrentBPlusTree();
+
+    ConcurrentBPlusTree(const ConcurrentBPlusTree &) = delete;
+    ConcurrentBPlusTree &operator=(const ConcurrentBPlusTree &) = delete;
+
+    // Insert a key-value pair, returns false if the key is already present
+    bool Insert(const KeyType &key, const RecordPointer &value);
+
+    // Remove a keyTp and its value, returns false if the key is not present
+    bool Remove(const KeyType &keyTp);
+
+    // return the value associated with a given keyTp
+    bool GetValue(const KeyType &keyTp, RecordPointer &result) const;
+
+    // return the values within a key range [key_start, key_end) not included key_end.
+    // Each leaf is read consistently; keys inserted or removed while the scan
+    // runs may or may not be seen.
+    void RangeScan(const KeyType &key_start, const KeyType &key_end,
+                   std::vector<RecordPointer> &result) const;
+
+    // return the bytes held by the nodes of this B+ tree
+    size_t MemoryUsage() const;
+
+private:
+    ConcurrentLeafNode *newLeafNode();
+    ConcurrentInternalNode *newInternalNode();
+
+    // Grows the tree by one level, the caller holds the latch of the old root
+    void makeRoot(const KeyType &keyTp, ConcurrentNode *leftNode, ConcurrentNode *rightNode);
+
+    // Descends to the leaf that may hold keyTp without taking any latch
+    ConcurrentLeafNode *findLeafNode(const KeyType &keyTp, uint64_t &leafVersion, bool &needRestart) const;
+
+    std::atomic<ConcurrentNode *> root;
+
+    NodePool<ConcurrentLeafNode> leaf_pool;
+    NodePool<ConcurrentInternalNode> internal_pool;
+    mutable std::mutex pool_mutex;  // node pools are not thread-safe, splits allocate under it
+};
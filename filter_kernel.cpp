@@ -0,0 +1,154 @@
+#include "../include/filter_kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <PredicateType type>
+inline bool compareVal1(int value1, int val) {
+    return type == PredicateType::GREATER ? value1 > val
+         : type == PredicateType::LESS    ? value1 < val
+                                          : value1 == val;
+}
+
+// Writes i to the next slot unconditionally and only advances on a match,
+// so there is no branch to mispredict on selective predicates.
+template <PredicateType type>
+size_t selectScalar(const int *values, size_t begin, size_t count, int val, uint32_t *sel, size_t selected) {
+    for (size_t i = begin; i < count; i++) {
+        sel[selected] = (uint32_t)i;
+        selected += compareVal1<type>(values[i], val);
+    }
+    return selected;
+}
+
+#ifdef FILTER_KERNEL_X86
+inline size_t appendSelected(unsigned mask, size_t base, uint32_t *sel, size_t selected) {
+    while (mask) {
+        sel[selected++] = (uint32_t)(base + __builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+    return selected;
+}
+
+template <PredicateType type>
+__attribute__((target("avx2")))
+size_t selectAvx2(const int *values, size_t count, int val, uint32_t *sel) {
+    const __m256i pivot = _mm256_set1_epi32(val);
+    size_t selected = 0, i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i block = _mm256_loadu_si256((const __m256i *)(values + i));
+        __m256i cmp;
+        if (type == PredicateType::GREATER) {
+            cmp = _mm256_cmpgt_epi32(block, pivot);
+        } else if (type == PredicateType::LESS) {
+            cmp = _mm256_cmpgt_epi32(pivot, block);
+        } else {
+            cmp = _mm256_cmpeq_epi32(block, pivot);
+        }
+        const unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+        selected = appendSelected(mask, i, sel, selected);
+    }
+    return selectScalar<type>(values, i, count, val, sel, selected);
+}
+
+template <PredicateType type>
+__attribute__((target("sse2")))
+size_t selectSse2(const int *values, size_t count, int val, uint32_t *sel) {
+    const __m128i pivot = _mm_set1_epi32(val);
+    size_t selected = 0, i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i block = _mm_loadu_si128((const __m128i *)(values + i));
+        __m128i cmp;
+        if (type == PredicateType::GREATER) {
+            cmp = _mm_cmpgt_epi32(block, pivot);
+        } else if (type == PredicateType::LESS) {
+            cmp = _mm_cmplt_epi32(block, pivot);
+        } else {
+            cmp = _mm_cmpeq_epi32(block, pivot);
+        }
+        const unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(cmp));
+        selected = appendSelected(mask, i, sel, selected);
+    }
+    return selectScalar<type>(values, i, count, val, sel, selected);
+}
+
+size_t selectVal1Avx2(const int *values, size_t count, int val, PredicateType type, uint32_t *sel) {
+    switch (type) {
+        case PredicateType::GREATER:
+            return selectAvx2<PredicateType::GREATER>(values, count, val, sel);
+        case PredicateType::LESS:
+            return selectAvx2<PredicateType::LESS>(values, count, val, sel);
+        case PredicateType::EQUAL:
+            return selectAvx2<PredicateType::EQUAL>(values, count, val, sel);
+        default:
+            return 0;
+    }
+}
+
+size_t selectVal1Sse2(const int *values, size_t count, int val, PredicateType type, uint32_t *sel) {
+    switch (type) {
+        case PredicateType::GREATER:
+            return selectSse2<PredicateType::GREATER>(values, count, val, sel);
+        case PredicateType::LESS:
+            return selectSse2<PredicateType::LESS>(values, count, val, sel);
+        case PredicateType::EQUAL:
+            return selectSse2<PredicateType::EQUAL>(values, count, val, sel);
+        default:
+            return 0;
+    }
+}
+#endif
+
+typedef size_t (*SelectVal1Fn)(const int *, size_t, int, PredicateType, uint32_t *);
+
+struct SelectVal1Impl {
+    SelectVal1Fn fn;
+    const char *isa;
+};
+
+// Picks the widest instruction set the running CPU supports
+SelectVal1Impl resolveSelectVal1() {
+#ifdef FILTER_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        SelectVal1Impl impl = {selectVal1Avx2, "avx2"};
+        return impl;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        SelectVal1Impl impl = {selectVal1Sse2, "sse2"};
+        return impl;
+    }
+#endif
+    SelectVal1Impl impl = {SelectVal1Scalar, "scalar"};
+    return impl;
+}
+
+const SelectVal1Impl &selectVal1Impl() {
+    static const SelectVal1Impl impl = resolveSelectVal1();
+    return impl;
+}
+
+}  // namespace
+
+size_t SelectVal1(const int *values, size_t count, int val, PredicateType type, uint32_t *sel) {
+    return selectVal1Impl().fn(values, count, val, type, sel);
+}
+
+size_t SelectVal1Scalar(const int *values, size_t count, int val, PredicateType type, uint32_t *sel) {
+    switch (type) {
+        case PredicateType::GREATER:
+            return selectScalar<PredicateType::GREATER>(values, 0, count, val, sel, 0);
+        case PredicateType::LESS:
+            return selectScalar<PredicateType::LESS>(values, 0, count, val, sel, 0);
+        case PredicateType::EQUAL:
+            return selectScalar<PredicateType::EQUAL>(values, 0, count, val, sel, 0);
+        default:
+            return 0;
+    }
+}
+
+const char *SelectVal1Isa() { return selectVal1Impl().isa; }
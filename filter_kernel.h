@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "filter_seq_scan_executor.h"
+
+/** Number of val1 values the filter scans evaluate per kernel call. */
+static const size_t FILTER_BLOCK_SIZE = 1024;
+
+/**
+ * Evaluate a predicate on a single val1 value.
+ * Same semantics as FilterPredicate::evaluate, without copying a tuple.
+ */
+inline bool PredicateMatches(int value1, int val, PredicateType type) {
+  switch (type) {
+    case PredicateType::GREATER:
+      return val < value1;
+    case PredicateType::LESS:
+      return val > value1;
+    case PredicateType::EQUAL:
+      return val == value1;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Evaluate a predicate over a block of val1 values and build a selection vector.
+ * Uses AVX2 or SSE2 when the CPU supports it (detected once at runtime through
+ * CPUID) and a branchless scalar loop otherwise.
+ * @param values the val1 values to filter
+ * @param count number of values
+ * @param val the predicate constant, as in FilterPredicate::val
+ * @param type the predicate condition, as in FilterPredicate::condition
+ * @param[out] sel receives the positions of the qualifying values in ascending
+ *                 order, must have room for count entries
+ * @return the number of positions written to sel
+ */
+size_t SelectVal1(const int *values, size_t count, int val, PredicateType type, uint32_t *sel);
+
+/** Scalar implementation of SelectVal1, used when no SIMD support is available. */
+size_t SelectVal1Scalar(const int *values, size_t count, int val, PredicateType type, uint32_t *sel);
+
+/** @return the name of the instruction set SelectVal1 dispatches to: "avx2", "sse2" or "scalar" */
+const char *SelectVal1Isa();
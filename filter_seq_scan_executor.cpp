@@ -1,17 +1,85 @@
 #include "../include/filter_seq_scan_executor.h"
 
+#include <algorithm>
+
+#include "../include/bloom_filter.h"
+#include "../include/filter_kernel.h"
+#include "../include/hash_join_executor.h"
+
 FilterSeqScanExecutor::FilterSeqScanExecutor(Table *table,
                                              FilterPredicate *pred)
-    : table_(table), pred_(pred){};
+    : table_(table),
+      pred_(pred),
+      bloom_filter_(NULL),
+      bloom_hash_fn_(NULL),
+      val1_block_(FILTER_BLOCK_SIZE),
+      selection_(FILTER_BLOCK_SIZE),
+      selection_size_(0),
+      selection_pos_(0){};
 
-void FilterSeqScanExecutor::Init() { iter_ = table_->Begin(); }
+void FilterSeqScanExecutor::Init() {
+    iter_ = table_->Begin();
+    selection_size_ = 0;
+    selection_pos_ = 0;
+}
 
 bool FilterSeqScanExecutor::Next(Tuple *tuple) {
-    while (iter_ != table_->End()) {
-        const Tuple &curr_tuple = *iter_;
-        *tuple = Tuple(curr_tuple);
-        ++iter_;
-        if (pred_->evaluate(*tuple)) return true;
+    const Tuple *curr_tuple;
+    if (!NextRef(&curr_tuple)) return false;
+    *tuple = *curr_tuple;
+    return true;
+}
+
+bool FilterSeqScanExecutor::NextRef(const Tuple **tuple) {
+    while (selection_pos_ == selection_size_) {
+        if (iter_ == table_->End()) return false;
+        selection_size_ = filterNextBlock(FILTER_BLOCK_SIZE);
+        selection_pos_ = 0;
+    }
+    *tuple = &block_begin_[selection_[selection_pos_++]];
+    return true;
+}
+
+bool FilterSeqScanExecutor::NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    // Rows selected by an earlier Next() call are handed out first
+    while (selection_pos_ < selection_size_ && !batch->IsFull()) {
+        *batch->Slot() = block_begin_[selection_[selection_pos_++]];
+        batch->Commit();
     }
-    return false;
+    // Every selected row of a block fits, since the block is no larger than the room left
+    while (iter_ != table_->End() && !batch->IsFull()) {
+        const size_t selected = filterNextBlock(batch->Capacity() - batch->Size());
+        for (size_t i = 0; i < selected; i++) {
+            *batch->Slot() = block_begin_[selection_[i]];
+            batch->Commit();
+        }
+    }
+    return !batch->IsEmpty();
+}
+
+size_t FilterSeqScanExecutor::filterNextBlock(size_t max_rows) {
+    const size_t rows = std::min(std::min(max_rows, FILTER_BLOCK_SIZE),
+                                 (size_t)(table_->End() - iter_));
+    block_begin_ = iter_;
+    for (size_t i = 0; i < rows; i++, ++iter_) {
+        val1_block_[i] = iter_->val1;
+    }
+    size_t selected = SelectVal1(val1_block_.data(), rows, pred_->val, pred_->condition, selection_.data());
+    if (bloom_filter_ != NULL) {
+        // compact the selection down to the rows that may find a join partner
+        size_t kept = 0;
+        for (size_t i = 0; i < selected; i++) {
+            selection_[kept] = selection_[i];
+            kept += bloom_filter_->MayContain(bloom_hash_fn_->GetHash(block_begin_[selection_[i]]));
+        }
+        selected = kept;
+    }
+    return selected;
+}
+
+bool FilterSeqScanExecutor::PushDownBloomFilter(const BlockedBloomFilter *filter, SimpleHashFunction *hash_fn) {
+    bloom_filter_ = filter;
+    bloom_hash_fn_ = hash_fn;
+    return true;
 }
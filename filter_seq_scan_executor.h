@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "abstract_executor.h"
@@ -55,8 +56,48 @@ class FilterSeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple) override;
 
+  /**
+   * Yield the next batch of tuples that satisfy the predicate.
+   * Rows are only copied into the batch once they pass the filter.
+   * @param batch the batch to fill with the next qualifying tuples
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /**
+   * Yield a pointer to the next qualifying tuple in the table without copying it.
+   * @param tuple set to the next tuple that satisfies the predicate
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextRef(const Tuple **tuple) override;
+
+  /**
+   * Also drop rows whose key hash is not in the filter, before they are copied.
+   * @param filter the filter pushed down by a hash join, NULL to remove it
+   * @param hash_fn the hash function of the join key
+   * @return `true`
+   */
+  bool PushDownBloomFilter(const BlockedBloomFilter *filter, SimpleHashFunction *hash_fn) override;
+
  private:
+  /**
+   * Evaluate the predicate over the next block of at most max_rows rows with
+   * the vectorized filter kernel, then the Bloom filter on the rows that
+   * pass. Fills selection_ with the positions of the
+   * qualifying rows relative to block_begin_ and advances iter_ past the block.
+   * @return the number of qualifying rows in the block
+   */
+  size_t filterNextBlock(size_t max_rows);
+
   Table *table_;
   std::vector<Tuple>::iterator iter_;
   FilterPredicate *pred_;
+  const BlockedBloomFilter *bloom_filter_;
+  SimpleHashFunction *bloom_hash_fn_;
+
+  std::vector<Tuple>::iterator block_begin_;  ///< First row of the filtered block
+  std::vector<int> val1_block_;               ///< val1 values of the block
+  std::vector<uint32_t> selection_;           ///< Qualifying positions in the block
+  size_t selection_size_;                     ///< Number of valid entries in selection_
+  size_t selection_pos_;                      ///< Next entry of selection_ Next() returns
 };
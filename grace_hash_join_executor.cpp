@@ -0,0 +1,207 @@
+#include "../include/grace_hash_join_executor.h"
+
+#include <iostream>
+
+namespace {
+
+// Directory bytes per build tuple in the worst case: the directory is kept at
+// most half full and doubles, so up to four 12-byte slots per key
+const size_t DIRECTORY_BYTES_PER_TUPLE = 48;
+
+// Rough memory a build tuple takes in SimpleHashJoinHashTable: the arena entry,
+// its chain index, its share of the directory and the val2 payload
+size_t buildTupleBytes(const Tuple &tuple) {
+    return sizeof(Tuple) + sizeof(uint32_t) + DIRECTORY_BYTES_PER_TUPLE + tuple.val2.size();
+}
+
+}  // namespace
+
+GraceHashJoinExecutor::GraceHashJoinExecutor(AbstractExecutor *left_child_executor,
+                                             AbstractExecutor *right_child_executor,
+                                             SimpleHashFunction *hash_fn,
+                                             size_t memory_limit,
+                                             const std::string &temp_dir,
+                                             size_t num_partitions)
+    : left_(left_child_executor),
+      right_(right_child_executor),
+      hash_fn_(hash_fn),
+      memory_limit_(memory_limit),
+      temp_dir_(temp_dir),
+      num_partitions_(2),
+      partition_bits_(1),
+      in_memory_(true),
+      failed_(false),
+      probe_remaining_(0) {
+    while (num_partitions_ < num_partitions && partition_bits_ < 16) {
+        num_partitions_ *= 2;
+        partition_bits_++;
+    }
+}
+
+void GraceHashJoinExecutor::Init() {
+    ht_.deleteValuesInHashTable();
+    pending_.clear();
+    probe_file_.reset();
+    match_ = SimpleHashJoinHashTable::BucketCursor();
+    in_memory_ = true;
+    failed_ = false;
+    probe_remaining_ = 0;
+
+    // Buffer the left child until it runs out or the memory budget is used up
+    left_->Init();
+    size_t bytes = 0;
+    const Tuple *tuple;
+    while (left_->NextRef(&tuple)) {
+        ht_.Insert(hash_fn_->GetHash(*tuple), *tuple);
+        bytes += buildTupleBytes(*tuple);
+        if (bytes > memory_limit_) {
+            in_memory_ = false;
+            break;
+        }
+    }
+    right_->Init();
+    if (in_memory_) return;
+
+    // The build side does not fit: partition what was buffered, the rest of
+    // the left child and the whole right child
+    PartitionWriter left_partitions, right_partitions;
+    bool spilled = true;
+    for (size_t i = 0; spilled && i < ht_.Size(); i++) {
+        spilled = spill(&left_partitions, ht_.TupleAt(i), 0);
+    }
+    if (!spilled) {
+        // Nothing is lost while the buffered tuples are still in the hash
+        // table: join in memory over the budget, as SortExecutor does
+        while (left_->NextRef(&tuple)) {
+            ht_.Insert(hash_fn_->GetHash(*tuple), *tuple);
+        }
+        in_memory_ = true;
+        return;
+    }
+    ht_.deleteValuesInHashTable();
+    while (spilled && left_->NextRef(&tuple)) {
+        spilled = spill(&left_partitions, *tuple, 0);
+    }
+    while (spilled && right_->NextRef(&tuple)) {
+        spilled = spill(&right_partitions, *tuple, 0);
+    }
+    if (!spilled) {
+        fail();
+        return;
+    }
+    addPartitionPairs(&left_partitions, &right_partitions, 0);
+}
+
+bool GraceHashJoinExecutor::Next(Tuple *tuple) {
+    for (;;) {
+        // emit the next match of the current probe tuple
+        if (!match_.IsEnd()) {
+            *tuple = *match_;
+            ++match_;
+            return true;
+        }
+        if (in_memory_) {
+            const Tuple *probeTuple;
+            if (!right_->NextRef(&probeTuple)) return false;
+            match_ = ht_.Find(hash_fn_->GetHash(*probeTuple));
+            continue;
+        }
+        if (probe_remaining_ > 0) {
+            if (!probe_file_->Read(&probe_tuple_)) {
+                fail();
+                return false;
+            }
+            probe_remaining_--;
+            match_ = ht_.Find(hash_fn_->GetHash(probe_tuple_));
+            continue;
+        }
+        if (failed_ || !loadNextPartition()) return false;
+    }
+}
+
+size_t GraceHashJoinExecutor::partitionOf(hash_t h, int depth) const {
+    // each pass uses the next partition_bits_ bits, from the top of the hash down
+    const int shift = 32 - partition_bits_ * (depth + 1);
+    return (shift >= 0 ? h >> shift : h << -shift) & (num_partitions_ - 1);
+}
+
+bool GraceHashJoinExecutor::spill(PartitionWriter *writer, const Tuple &tuple, int depth) {
+    if (writer->files.empty()) {
+        writer->files.resize(num_partitions_);
+        writer->bytes.resize(num_partitions_, 0);
+    }
+    const size_t partition = partitionOf(hash_fn_->GetHash(tuple), depth);
+    std::unique_ptr<SpillFile> &file = writer->files[partition];
+    if (!file) file.reset(new SpillFile(temp_dir_));
+    writer->bytes[partition] += buildTupleBytes(tuple);
+    return file->Append(tuple);
+}
+
+void GraceHashJoinExecutor::addPartitionPairs(PartitionWriter *left, PartitionWriter *right, int depth) {
+    for (size_t i = 0; i < left->files.size() && i < right->files.size(); i++) {
+        // a partition that is empty on either side produces no tuples
+        if (!left->files[i] || !right->files[i]) continue;
+        PartitionPair pair;
+        pair.left = std::move(left->files[i]);
+        pair.right = std::move(right->files[i]);
+        pair.left_bytes = left->bytes[i];
+        pair.depth = depth + 1;
+        pending_.push_back(std::move(pair));
+    }
+}
+
+bool GraceHashJoinExecutor::respill(SpillFile *file, PartitionWriter *writer, int depth) {
+    if (!file->Rewind()) return false;
+    Tuple tuple;
+    // only complete records are counted, so a short file is a read error
+    for (size_t i = 0; i < file->Size(); i++) {
+        if (!file->Read(&tuple) || !spill(writer, tuple, depth)) return false;
+    }
+    return true;
+}
+
+bool GraceHashJoinExecutor::loadNextPartition() {
+    const int max_depth = 32 / partition_bits_;
+    while (!pending_.empty()) {
+        PartitionPair pair = std::move(pending_.back());
+        pending_.pop_back();
+
+        // Still too large: split the pair again on the next hash bits. If the
+        // smaller partitions cannot be written, the pair is joined in memory.
+        if (pair.left_bytes > memory_limit_ && pair.depth < max_depth) {
+            PartitionWriter left_partitions, right_partitions;
+            if (respill(pair.left.get(), &left_partitions, pair.depth) &&
+                respill(pair.right.get(), &right_partitions, pair.depth)) {
+                addPartitionPairs(&left_partitions, &right_partitions, pair.depth);
+                continue;
+            }
+        }
+
+        ht_.deleteValuesInHashTable();
+        ht_.Reserve(pair.left->Size());
+        Tuple tuple;
+        bool loaded = pair.left->Rewind() && pair.right->Rewind();
+        for (size_t i = 0; loaded && i < pair.left->Size(); i++) {
+            loaded = pair.left->Read(&tuple);
+            if (loaded) ht_.Insert(hash_fn_->GetHash(tuple), tuple);
+        }
+        if (!loaded) {
+            fail();
+            return false;
+        }
+        probe_file_ = std::move(pair.right);
+        probe_remaining_ = probe_file_->Size();
+        return true;
+    }
+    return false;
+}
+
+void GraceHashJoinExecutor::fail() {
+    std::cout << "ERROR: Could not spill the join inputs to " << temp_dir_ << std::endl;
+    failed_ = true;
+    pending_.clear();
+    probe_file_.reset();
+    probe_remaining_ = 0;
+    ht_.deleteValuesInHashTable();
+    match_ = SimpleHashJoinHashTable::BucketCursor();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "hash_join_executor.h"
+#include "spill_file.h"
+#include "storage.h"
+
+/** Default memory budget of the build side of a Grace hash join, in bytes. */
+static const size_t DEFAULT_JOIN_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+/**
+ * GraceHashJoinExecutor executes a hash join whose build side may exceed memory.
+ * It produces the same tuples as HashJoinExecutor: for every right tuple, each
+ * left tuple whose join key has the same hash.
+ *
+ * The left child is buffered up to memory_limit bytes. If it fits, the join
+ * runs in memory and streams the right child. Otherwise both children are
+ * partitioned on SimpleHashFunction hash bits into spill files under temp_dir
+ * and joined one partition pair at a time; a left partition that is still
+ * too large is partitioned again on the next hash bits. In that case tuples
+ * come out grouped by partition rather than in right-child order.
+ *
+ * If the buffered tuples cannot be spilled, the join runs in memory over the
+ * budget. A partition that cannot be split again is joined in memory as is.
+ * Once tuples that left memory cannot be written or read back, the error is
+ * reported and the join produces no further tuples.
+ */
+class GraceHashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new Grace hash join executor.
+   * @param left_child_executor the left child, used to build the hash table
+   * @param right_child_executor the right child, used to probe the hash table
+   * @param hash_fn the hash function of the join key
+   * @param memory_limit memory budget of an in-memory build side, in bytes
+   * @param temp_dir directory for spill files
+   * @param num_partitions fan-out of each partitioning pass, rounded up to a power of two
+   */
+  GraceHashJoinExecutor(AbstractExecutor *left_child_executor,
+                        AbstractExecutor *right_child_executor,
+                        SimpleHashFunction *hash_fn,
+                        size_t memory_limit = DEFAULT_JOIN_MEMORY_LIMIT,
+                        const std::string &temp_dir = DEFAULT_SPILL_DIR,
+                        size_t num_partitions = 16);
+
+  /** Initialize the join, partitioning both children if the left one does not fit in memory */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from join.
+   * @param tuple the next tuple produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+ private:
+  /** A pair of spill files holding the tuples of one hash partition of each child. */
+  struct PartitionPair {
+    std::unique_ptr<SpillFile> left;
+    std::unique_ptr<SpillFile> right;
+    size_t left_bytes;  ///< estimated memory needed to build a hash table over left
+    int depth;          ///< number of partitioning passes the tuples went through
+  };
+
+  /** Spill files being written by one partitioning pass. */
+  struct PartitionWriter {
+    std::vector<std::unique_ptr<SpillFile>> files;
+    std::vector<size_t> bytes;
+  };
+
+  /** @return the partition of a hash at the given partitioning depth */
+  size_t partitionOf(hash_t h, int depth) const;
+
+  /**
+   * Append a tuple to its partition, creating the spill file on first use.
+   * @return `false` if the tuple could not be written
+   */
+  bool spill(PartitionWriter *writer, const Tuple &tuple, int depth);
+
+  /**
+   * Partition every tuple of a spill file again on the next hash bits.
+   * @return `false` if a tuple could not be read or written
+   */
+  bool respill(SpillFile *file, PartitionWriter *writer, int depth);
+
+  /** Report lost spilled tuples and end the join's output. */
+  void fail();
+
+  /** Turn the left and right partitions of one pass into pending partition pairs. */
+  void addPartitionPairs(PartitionWriter *left, PartitionWriter *right, int depth);
+
+  /**
+   * Build the hash table over the next pending partition pair whose left side
+   * fits in memory, re-partitioning pairs that do not.
+   * @return `false` if there are no partitions left
+   */
+  bool loadNextPartition();
+
+  AbstractExecutor *left_;
+  AbstractExecutor *right_;
+  SimpleHashFunction *hash_fn_;
+  size_t memory_limit_;
+  std::string temp_dir_;
+  size_t num_partitions_;
+  int partition_bits_;
+
+  SimpleHashJoinHashTable ht_;
+  bool in_memory_;                                ///< Whether the build side fit in memory
+  std::vector<PartitionPair> pending_;            ///< Partition pairs still to join
+  bool failed_;                                   ///< Whether spilled tuples were lost
+  std::unique_ptr<SpillFile> probe_file_;         ///< Right partition being probed
+  size_t probe_remaining_;                        ///< Tuples of probe_file_ not read yet
+  Tuple probe_tuple_;                             ///< Current tuple read from probe_file_
+  SimpleHashJoinHashTable::BucketCursor match_;   ///< Matches of the current probe tuple
+};
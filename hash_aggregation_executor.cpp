@@ -0,0 +1,202 @@
+#include "../include/hash_aggregation_executor.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+// A spilled build is split into 2^SPILL_BITS partitions on the next hash bits
+const int SPILL_BITS = 4;
+const size_t SPILL_FANOUT = 1 << SPILL_BITS;
+// Deeper than this all 32 hash bits are used, so a partition is aggregated in memory
+const int MAX_SPILL_DEPTH = 32 / SPILL_BITS;
+const size_t MIN_GROUP_TABLE_CAPACITY = 16;
+
+}  // namespace
+
+void GroupByHashTable::Reset(size_t estimated_groups, size_t memory_limit) {
+    size_t capacity = MIN_GROUP_TABLE_CAPACITY;
+    // keep the load factor under 3/4
+    while (capacity * 3 < estimated_groups * 4) capacity *= 2;
+    while (capacity > MIN_GROUP_TABLE_CAPACITY && capacity * sizeof(Entry) > memory_limit / 2) capacity /= 2;
+    entries_.clear();
+    entries_.resize(capacity);
+    size_ = 0;
+    key_bytes_ = 0;
+}
+
+size_t GroupByHashTable::probe(hash_t h, const Tuple &tuple) const {
+    const size_t mask = entries_.size() - 1;
+    size_t slot = h & mask;
+    while (entries_[slot].used) {
+        if (entries_[slot].hash == h && KeysEqual(entries_[slot].key, tuple, column_)) break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+AggregationState *GroupByHashTable::FindOrInsert(hash_t h, const Tuple &tuple, size_t memory_limit) {
+    size_t slot = probe(h, tuple);
+    if (entries_[slot].used) return &entries_[slot].state;
+
+    // counted by size, so whether a key fits never changes while the table only grows
+    const size_t new_key_bytes = column_ == TupleColumn::VAL2 ? tuple.val2.size() : 0;
+    if ((size_ + 1) * 4 > entries_.size() * 3) {
+        if (2 * entries_.size() * sizeof(Entry) + key_bytes_ + new_key_bytes > memory_limit) return NULL;
+        grow();
+        slot = probe(h, tuple);
+    } else if (MemoryUsage() + new_key_bytes > memory_limit) {
+        return NULL;
+    }
+
+    Entry &entry = entries_[slot];
+    entry.used = true;
+    entry.hash = h;
+    CopyKey(tuple, &entry.key, column_);
+    size_++;
+    key_bytes_ += new_key_bytes;
+    return &entry.state;
+}
+
+void GroupByHashTable::grow() {
+    std::vector<Entry> old_entries(entries_.size() * 2);
+    old_entries.swap(entries_);
+    const size_t mask = entries_.size() - 1;
+    for (size_t i = 0; i < old_entries.size(); i++) {
+        if (!old_entries[i].used) continue;
+        size_t slot = old_entries[i].hash & mask;
+        while (entries_[slot].used) slot = (slot + 1) & mask;
+        std::swap(entries_[slot], old_entries[i]);
+    }
+}
+
+HashAggregationExecutor::HashAggregationExecutor(AbstractExecutor *child_executor, const std::string &group_by,
+                                                 AggregationType aggr_type, size_t estimated_groups,
+                                                 size_t memory_limit, const std::string &temp_dir)
+    : child_(child_executor),
+      aggr_type_(aggr_type),
+      column_(TupleColumn::ID),
+      valid_key_(ParseTupleColumn(group_by, &column_)),
+      estimated_groups_(estimated_groups),
+      memory_limit_(memory_limit),
+      temp_dir_(temp_dir),
+      hash_fn_(group_by),
+      groups_(column_),
+      slot_(0),
+      failed_(false){};
+
+void HashAggregationExecutor::Init() {
+    pending_.clear();
+    groups_.Reset(estimated_groups_, memory_limit_);
+    slot_ = 0;
+    failed_ = false;
+    if (!valid_key_) return;
+
+    child_->Init();
+    const Tuple *tuple;
+    while (!failed_ && child_->NextRef(&tuple)) {
+        aggregate(*tuple, 0);
+    }
+    finishBuild(0);
+}
+
+bool HashAggregationExecutor::Next(Tuple *tuple) {
+    if (failed_) return false;
+    for (;;) {
+        while (slot_ < groups_.Capacity()) {
+            const GroupByHashTable::Entry &entry = groups_.EntryAt(slot_++);
+            if (!entry.used) continue;
+            const int result = (int)entry.state.Result(aggr_type_);
+            tuple->id = 0;
+            tuple->val1 = 0;
+            tuple->val2.clear();
+            CopyKey(entry.key, tuple, column_);
+            if (column_ == TupleColumn::VAL1) {
+                tuple->id = result;
+            } else {
+                tuple->val1 = result;
+            }
+            return true;
+        }
+        if (pending_.empty()) return false;
+
+        // Aggregate the next spilled partition
+        std::unique_ptr<SpillFile> partition(pending_.back().first.release());
+        const int depth = pending_.back().second;
+        pending_.pop_back();
+        groups_.Reset(estimated_groups_ > 0 ? std::min(partition->Size(), estimated_groups_) : 0, memory_limit_);
+        slot_ = 0;
+        if (!aggregatePartition(partition.get(), depth)) return false;
+        finishBuild(depth);
+    }
+}
+
+void HashAggregationExecutor::aggregate(const Tuple &tuple, int depth) {
+    const hash_t h = hashKey(tuple);
+    const size_t limit = depth < MAX_SPILL_DEPTH ? memory_limit_ : std::numeric_limits<size_t>::max();
+    AggregationState *state = groups_.FindOrInsert(h, tuple, limit);
+    if (state == NULL) {
+        if (partitions_.empty()) {
+            partitions_.resize(SPILL_FANOUT);
+            memory_partitions_.assign(SPILL_FANOUT, false);
+        }
+        const size_t index = (h >> (32 - SPILL_BITS * (depth + 1))) & (SPILL_FANOUT - 1);
+        if (!memory_partitions_[index]) {
+            std::unique_ptr<SpillFile> &partition = partitions_[index];
+            if (!partition) partition.reset(new SpillFile(temp_dir_));
+            if (partition->Append(tuple)) return;
+            // The partition cannot be written, so its whole hash range is kept in
+            // memory from now on, including the groups already spilled to it
+            memory_partitions_[index] = true;
+            if (!aggregatePartition(partition.get(), MAX_SPILL_DEPTH)) return;
+            partition.reset();
+        }
+        state = groups_.FindOrInsert(h, tuple, std::numeric_limits<size_t>::max());
+    }
+    state->Update(tuple.val1);
+}
+
+bool HashAggregationExecutor::aggregatePartition(SpillFile *partition, int depth) {
+    if (partition->Size() == 0) return true;
+    if (!partition->Rewind()) {
+        std::cout << "ERROR: Could not read back spilled groups" << std::endl;
+        failed_ = true;
+        return false;
+    }
+    // Only complete records are counted, a failed append may have left part of one behind
+    Tuple spilled;
+    for (size_t i = 0; i < partition->Size(); i++) {
+        if (!partition->Read(&spilled)) {
+            std::cout << "ERROR: Could not read back spilled groups" << std::endl;
+            failed_ = true;
+            return false;
+        }
+        aggregate(spilled, depth);
+        if (failed_) return false;
+    }
+    return true;
+}
+
+void HashAggregationExecutor::finishBuild(int depth) {
+    for (size_t i = 0; i < partitions_.size(); i++) {
+        if (partitions_[i] && partitions_[i]->Size() > 0) {
+            pending_.push_back(std::make_pair(std::move(partitions_[i]), depth + 1));
+        }
+    }
+    partitions_.clear();
+    memory_partitions_.clear();
+}
+
+hash_t HashAggregationExecutor::hashKey(const Tuple &tuple) {
+    switch (column_) {
+        case TupleColumn::ID:
+            return hash_fn_.int2hash(tuple.id);
+        case TupleColumn::VAL1:
+            return hash_fn_.int2hash(tuple.val1);
+        case TupleColumn::VAL2:
+            return hash_fn_.str2hash(tuple.val2);
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "aggregation_executor.h"
+#include "hash_join_executor.h"
+#include "spill_file.h"
+#include "storage.h"
+#include "tuple_column.h"
+
+/** Default memory budget of the in-memory group table, in bytes. */
+static const size_t DEFAULT_AGGREGATION_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+/**
+ * An open-addressing (linear probing) hash table from a group key to its
+ * running AggregationState. Only the key column of each stored tuple is set.
+ */
+class GroupByHashTable {
+ public:
+  struct Entry {
+    Entry() : used(false), hash(0) {}
+    bool used;
+    hash_t hash;
+    Tuple key;
+    AggregationState state;
+  };
+
+  /** Creates a new group table keyed on column. */
+  explicit GroupByHashTable(TupleColumn column) : column_(column), size_(0), key_bytes_(0) {}
+
+  /**
+   * Drop all groups and size the table for the expected number of groups.
+   * @param estimated_groups expected number of distinct keys, 0 if unknown
+   * @param memory_limit the initial table is never larger than half of this
+   */
+  void Reset(size_t estimated_groups, size_t memory_limit);
+
+  /**
+   * Find the state of the group of a tuple, creating the group if needed.
+   * @param h the hash of the tuple's key
+   * @param tuple the tuple whose key to look up
+   * @param memory_limit a new group is not created if that would grow the
+   *                     table beyond this many bytes
+   * @return the group's state, or NULL if the group does not exist and there
+   *         is no memory left to create it
+   */
+  AggregationState *FindOrInsert(hash_t h, const Tuple &tuple, size_t memory_limit);
+
+  /** @return the number of slots, used or not */
+  size_t Capacity() const { return entries_.size(); }
+
+  /** @return the number of groups */
+  size_t Size() const { return size_; }
+
+  const Entry &EntryAt(size_t slot) const { return entries_[slot]; }
+
+  /** @return the approximate number of bytes held by the table */
+  size_t MemoryUsage() const { return entries_.size() * sizeof(Entry) + key_bytes_; }
+
+ private:
+  /** @return the slot holding the key of tuple, or the empty slot it belongs to */
+  size_t probe(hash_t h, const Tuple &tuple) const;
+
+  /** Double the number of slots and re-insert every group. */
+  void grow();
+
+  TupleColumn column_;
+  std::vector<Entry> entries_;
+  size_t size_;
+  size_t key_bytes_;  ///< Heap bytes of val2 keys
+};
+
+/**
+ * HashAggregationExecutor computes an aggregation over "val1" per group of
+ * equal keys (e.g. SUM(val1) GROUP BY val2) and emits one tuple per group.
+ *
+ * Each output tuple carries the group key in its key attribute and the
+ * aggregation result in "val1", the other attributes being 0 or empty. When
+ * grouping by "val1" itself, the key stays in "val1" and the result goes to "id".
+ *
+ * Groups are kept in a GroupByHashTable sized from a cardinality estimate.
+ * Once the table reaches the memory limit, tuples of groups that are not in
+ * memory are partitioned on their hash bits into spill files, and each
+ * partition is aggregated on its own after the in-memory groups are emitted.
+ * A partition that cannot be written is read back and its hash range kept in
+ * memory. If spilled groups cannot be read back, the error is reported and no
+ * further groups are produced.
+ */
+class HashAggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new hash aggregation executor.
+   * @param child_executor the child executor producing the tuples to group
+   * @param group_by the attribute to group on, one of {"id","val1","val2"}
+   * @param aggr_type the aggregation to compute per group
+   * @param estimated_groups expected number of groups, 0 if unknown
+   * @param memory_limit memory budget of the group table, in bytes
+   * @param temp_dir directory for spill files
+   */
+  HashAggregationExecutor(AbstractExecutor *child_executor, const std::string &group_by,
+                          AggregationType aggr_type, size_t estimated_groups = 0,
+                          size_t memory_limit = DEFAULT_AGGREGATION_MEMORY_LIMIT,
+                          const std::string &temp_dir = DEFAULT_SPILL_DIR);
+
+  /** Initialize the aggregation, consuming the whole child. */
+  void Init() override;
+
+  /**
+   * Yield the result of the next group.
+   * @param tuple the next group's key and aggregation result
+   * @return `true` if a tuple was produced, `false` if there are no more groups
+   */
+  bool Next(Tuple *tuple) override;
+
+ private:
+  /** Aggregate one tuple into the group table, spilling it if there is no room. */
+  void aggregate(const Tuple &tuple, int depth);
+
+  /**
+   * Aggregate the tuples of a spilled partition into the group table.
+   * @param depth the spill depth to aggregate at, MAX_SPILL_DEPTH keeps every group in memory
+   * @return `false` if the partition could not be read back, which fails the aggregation
+   */
+  bool aggregatePartition(SpillFile *partition, int depth);
+
+  /** Queue the partitions spilled while building the current group table. */
+  void finishBuild(int depth);
+
+  hash_t hashKey(const Tuple &tuple);
+
+  AbstractExecutor *child_;
+  AggregationType aggr_type_;
+  TupleColumn column_;
+  bool valid_key_;
+  size_t estimated_groups_;
+  size_t memory_limit_;
+  std::string temp_dir_;
+  SimpleHashFunction hash_fn_;
+
+  GroupByHashTable groups_;
+  size_t slot_;  ///< Next slot of groups_ to emit
+  bool failed_;  ///< Whether spilled groups were lost, which ends the output
+  std::vector<std::unique_ptr<SpillFile>> partitions_;  ///< Spill partitions of the current build
+  std::vector<bool> memory_partitions_;  ///< Hash ranges of the current build that can no longer spill
+  std::vector<std::pair<std::unique_ptr<SpillFile>, int>> pending_;  ///< Spilled partitions and their depth
+};
@@ -2,76 +2,93 @@
 
 HashJoinExecutor::HashJoinExecutor(AbstractExecutor *left_child_executor,
                                    AbstractExecutor *right_child_executor,
-                                   SimpleHashFunction *hash_fn)
+                                   SimpleHashFunction *hash_fn,
+                                   size_t build_size_hint,
+                                   bool bloom_filter_pushdown)
     : left_(left_child_executor),
       right_(right_child_executor),
-      hash_fn_(hash_fn) {}
+      hash_fn_(hash_fn),
+      build_size_hint_(build_size_hint),
+      bloom_filter_pushdown_(bloom_filter_pushdown),
+      bloom_filter_pushed_(false) {}
 
 void HashJoinExecutor::Init() {
+    // a join restarted before the probe side was exhausted still has its filter pushed down
+    detachBloomFilter();
     // Delete the old values already present in the hashtable
     ht.deleteValuesInHashTable();
-    // define a new tuple
-    Tuple tuple;
+    ht.Reserve(build_size_hint_);
+    // only build a Bloom filter if the probe side can use it; it is filled
+    // before right_->Init(), the first point where the child reads it
+    bloom_filter_pushed_ = bloom_filter_pushdown_ && right_->PushDownBloomFilter(&bloom_filter_, hash_fn_);
+    build_hashes_.clear();
+    // view each build tuple in place, the hash table keeps its own copy
+    const Tuple *tuple;
     // initialise the left index
     left_->Init();
-    while (left_->Next(&tuple))  {
-        ht.Insert(hash_fn_->GetHash(tuple), tuple);
+    while (left_->NextRef(&tuple))  {
+        const hash_t h = hash_fn_->GetHash(*tuple);
+        ht.Insert(h, *tuple);
+        if (bloom_filter_pushed_) build_hashes_.push_back(h);
+    }
+    // summarize the build keys so the probe-side scan drops non-matching rows
+    if (bloom_filter_pushed_) {
+        bloom_filter_.Reset(build_hashes_.size());
+        for (size_t i = 0; i < build_hashes_.size(); i++) {
+            bloom_filter_.Insert(build_hashes_[i]);
+        }
     }
     right_->Init();
 
-    // flag used to check further or not
-    shouldCheckFurther = true;
-    // row index to point the Index
-    rowIndex = 0;
+    // no probe tuple yet, so no matches to emit
+    match_ = SimpleHashJoinHashTable::BucketCursor();
+    probeBatch.Clear();
+    probeBatchPos = 0;
 }
 
 bool HashJoinExecutor::Next(Tuple *tuple) {
-    // if no flag present or no rows present
-    if (!shouldCheckFurther && rowIndex == 0) {
-          return false;
+    for (;;) {
+        // emit the next match of the current probe tuple
+        if (!match_.IsEnd()) {
+            *tuple = *match_;
+            ++match_;
+            return true;
+        }
+        // otherwise probe with the next tuple of the right table
+        const Tuple *probeTuple;
+        if (!right_->NextRef(&probeTuple)) {
+            detachBloomFilter();
+            return false;
+        }
+        match_ = ht.Find(hash_fn_->GetHash(*probeTuple));
     }
+}
 
-    // If we have rows then check
-    if (rowIndex > 0) {
-      // create a vector to add tuples
-      std::vector<Tuple> newTupleVector;
-      // get hash value of the key
-      ht.GetValue(hash_fn_->GetHash(*tuple), &newTupleVector);
-
-      // check if new tuple vector empty or not
-      if (!newTupleVector.empty()) {
-          // if vector value more than rowIndex
-        if (newTupleVector.size() > rowIndex) {
-            // new Tuple Vector
-          *tuple = newTupleVector[rowIndex++];
-          shouldCheckFurther = false;
-          return true;
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    while (!batch->IsFull()) {
+        // emit the rest of the bucket matched by the current probe tuple
+        if (!match_.IsEnd()) {
+            *batch->Slot() = *match_;
+            batch->Commit();
+            ++match_;
+            continue;
         }
-        shouldCheckFurther = true;
-        rowIndex = 0;
-        if(Next(tuple)) return true;
-      }
-    } else {
-        // check if right table has next tuple
-      while (right_->Next(tuple)) {
-          // new vector for the right table
-        std::vector<Tuple> newTupleVector;
-        ht.GetValue(hash_fn_->GetHash(*tuple), &newTupleVector);
-        // if new tuple vector is not empty
-        if (!newTupleVector.empty()) {
-            // if the vector sum is greater than newTupleVector
-          if (newTupleVector.size() > rowIndex) {
-            *tuple = newTupleVector[rowIndex++];
-            shouldCheckFurther = false;
-            return true;
-          }
-            shouldCheckFurther = true;
-            rowIndex = 0;
+        // pull the next batch of the right table once the current one is consumed
+        if (probeBatchPos == probeBatch.Size()) {
+            probeBatchPos = 0;
+            if (!right_->NextBatch(&probeBatch)) {
+                detachBloomFilter();
+                break;
+            }
         }
-      }
-      shouldCheckFurther = true;
-      rowIndex = 0;
+        match_ = ht.Find(hash_fn_->GetHash(probeBatch[probeBatchPos++]));
     }
-    // return false if no tuple is present
-    return false;
+    return !batch->IsEmpty();
+}
+
+void HashJoinExecutor::detachBloomFilter() {
+    if (!bloom_filter_pushed_) return;
+    right_->PushDownBloomFilter(NULL, NULL);
+    bloom_filter_pushed_ = false;
 }
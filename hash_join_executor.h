@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -8,6 +10,7 @@
 #include <vector>
 
 #include "abstract_executor.h"
+#include "bloom_filter.h"
 
 using hash_t = unsigned int;
 
@@ -47,7 +50,7 @@ public:
     // calculate the hash for a string type value
     // refer from
     // https://stackoverflow.com/a/51276700/5862966
-    hash_t str2hash(const std::string key) {
+    hash_t str2hash(const std::string &key) {
         uint32_t hash = 0x811c9dc5;
         uint32_t prime = 0x1000193;
 
@@ -60,13 +63,37 @@ public:
     }
 };
 
+/** Marks the end of a chain, or an empty directory slot, in SimpleHashJoinHashTable. */
+static const uint32_t HASH_TABLE_NO_TUPLE = 0xffffffff;
+
+/** Smallest directory size of SimpleHashJoinHashTable. */
+static const size_t HASH_TABLE_MIN_DIRECTORY_SIZE = 64;
+
 /**
  * A simple hash table that supports hash joins.
+ *
+ * Tuples are stored in one contiguous arena in insertion order. A flat,
+ * open-addressing directory (linear probing) maps each hash key to the first
+ * and last arena index of its chain, and tuples with the same key are linked
+ * through a parallel array of next indices. Inserting therefore never
+ * allocates per key, and clearing keeps the arena for the next build.
  */
 class SimpleHashJoinHashTable {
 public:
     /** Creates a new simple hash join hash table. */
-    SimpleHashJoinHashTable() {}
+    SimpleHashJoinHashTable() : num_keys_(0) { resizeDirectory(HASH_TABLE_MIN_DIRECTORY_SIZE); }
+
+    /**
+     * Pre-size the table for a build side of known size.
+     * @param num_tuples the number of tuples that will be inserted
+     */
+    void Reserve(size_t num_tuples) {
+        tuples_.reserve(num_tuples);
+        next_.reserve(num_tuples);
+        size_t size = HASH_TABLE_MIN_DIRECTORY_SIZE;
+        while (size < num_tuples * 2) size *= 2;
+        if (size > directory_.size()) resizeDirectory(size);
+    }
 
     /**
      * Inserts a (hash key, tuple) pair into the hash table.
@@ -75,23 +102,116 @@ public:
      * @return true if the insert succeeded
      */
     bool Insert(hash_t h, const Tuple &t) {
-        hash_table_[h].emplace_back(t);
+        const uint32_t index = (uint32_t)tuples_.size();
+        tuples_.push_back(t);
+        next_.push_back(HASH_TABLE_NO_TUPLE);
+
+        Slot &slot = directory_[findSlot(h)];
+        if (slot.head != HASH_TABLE_NO_TUPLE) {
+            next_[slot.tail] = index;
+            slot.tail = index;
+            return true;
+        }
+        slot.hash = h;
+        slot.head = slot.tail = index;
+        // keep the directory at most half full
+        if (++num_keys_ * 2 > directory_.size()) resizeDirectory(directory_.size() * 2);
         return true;
     }
+
+    /**
+     * A read-only cursor over the tuples that match one hash key, in
+     * insertion order. It stays valid until the table is modified.
+     */
+    class BucketCursor {
+    public:
+        BucketCursor() : table_(NULL), index_(HASH_TABLE_NO_TUPLE) {}
+
+        /** @return true once every matching tuple has been visited */
+        bool IsEnd() const { return index_ == HASH_TABLE_NO_TUPLE; }
+
+        const Tuple &operator*() const { return table_->tuples_[index_]; }
+        const Tuple *operator->() const { return &table_->tuples_[index_]; }
+
+        /** Move to the next matching tuple. */
+        BucketCursor &operator++() {
+            index_ = table_->next_[index_];
+            return *this;
+        }
+
+    private:
+        friend class SimpleHashJoinHashTable;
+        BucketCursor(const SimpleHashJoinHashTable *table, uint32_t index) : table_(table), index_(index) {}
+
+        const SimpleHashJoinHashTable *table_;
+        uint32_t index_;
+    };
+
+    /**
+     * Finds the tuples in the hash table that match the given hash key without copying them.
+     * @param h the hash key
+     * @return a cursor on the first matching tuple, at its end if there is none
+     */
+    BucketCursor Find(hash_t h) const { return BucketCursor(this, directory_[findSlot(h)].head); }
+
     /**
      * Gets the values in the hash table that match the given hash key.
      * @param h the hash key
-     * @param[out] t the list of tuples that matched the key
+     * @param[out] t the list of tuples that matched the key, in insertion order
      */
-    void GetValue(hash_t h, std::vector<Tuple> *t) { *t = hash_table_[h]; }
-    void deleteValuesInHashTable() {
-        hash_table_.clear();
+    void GetValue(hash_t h, std::vector<Tuple> *t) {
+        t->clear();
+        for (BucketCursor it = Find(h); !it.IsEnd(); ++it) {
+            t->push_back(*it);
+        }
     }
 
+    /** @return the number of tuples in the hash table */
+    size_t Size() const { return tuples_.size(); }
 
+    /**
+     * Gets a stored tuple by its position in insertion order.
+     * @param index position of the tuple, smaller than Size()
+     */
+    const Tuple &TupleAt(size_t index) const { return tuples_[index]; }
+
+    void deleteValuesInHashTable() {
+        tuples_.clear();
+        next_.clear();
+        std::fill(directory_.begin(), directory_.end(), Slot());
+        num_keys_ = 0;
+    }
 
 private:
-    std::unordered_map<hash_t, std::vector<Tuple>> hash_table_;
+    struct Slot {
+        Slot() : hash(0), head(HASH_TABLE_NO_TUPLE), tail(HASH_TABLE_NO_TUPLE) {}
+        hash_t hash;
+        uint32_t head;  ///< first tuple of the chain
+        uint32_t tail;  ///< last tuple of the chain, where inserts append
+    };
+
+    /** @return the slot of key h, or the empty slot where it would go */
+    size_t findSlot(hash_t h) const {
+        const size_t mask = directory_.size() - 1;
+        size_t slot = h & mask;
+        while (directory_[slot].head != HASH_TABLE_NO_TUPLE && directory_[slot].hash != h) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void resizeDirectory(size_t size) {
+        std::vector<Slot> old_directory(size);
+        old_directory.swap(directory_);
+        for (size_t i = 0; i < old_directory.size(); i++) {
+            if (old_directory[i].head != HASH_TABLE_NO_TUPLE) directory_[findSlot(old_directory[i].hash)] = old_directory[i];
+        }
+    }
+
+    std::vector<Tuple> tuples_;     ///< arena of all inserted tuples
+    std::vector<uint32_t> next_;    ///< next_[i] is the tuple after tuples_[i] in its chain
+    std::vector<Slot> directory_;   ///< open-addressing directory, power of two size
+    size_t num_keys_;               ///< number of used directory slots
 };
 /**
  * HashJoinExecutor executes hash join operations.
@@ -104,10 +224,19 @@ public:
      * hash table
      * @param right_child_executor the right child, used by convention to probe
      * the hash table
+     * @param build_size_hint the number of tuples of the left child if known,
+     * used to pre-size the hash table; 0 if unknown
+     * @param bloom_filter_pushdown whether to build a Bloom filter over the
+     * build-side hashes and push it down to the right child, so probe tuples
+     * that cannot match are dropped by the scan before being copied. The
+     * filter stays on the right child until the probe side is exhausted or
+     * Init() runs again, so the right child must not be shared meanwhile
      */
     HashJoinExecutor(AbstractExecutor *left_child_executor,
                      AbstractExecutor *right_child_executor,
-                     SimpleHashFunction *hash_fn);
+                     SimpleHashFunction *hash_fn,
+                     size_t build_size_hint = 0,
+                     bool bloom_filter_pushdown = false);
 
     /** Initialize the join
      * Hint: For hash join, you can initialize your hash table here first
@@ -122,14 +251,30 @@ public:
      */
     bool Next(Tuple *tuple) override;
 
+    /**
+     * Yield the next batch of joined tuples. The right child is probed batch
+     * by batch and every tuple of a matching bucket is emitted.
+     * @param batch the batch to fill with the next matching build-side tuples
+     * @return `true` if a tuple was produced, `false` if there are no more tuples
+     */
+    bool NextBatch(TupleBatch *batch) override;
+
 private:
+    /** Take the Bloom filter back from the right child if it was pushed down. */
+    void detachBloomFilter();
+
     AbstractExecutor *left_;
     AbstractExecutor *right_;
     SimpleHashJoinHashTable ht;
     SimpleHashFunction *hash_fn_;
-    bool performNextProbe;
-    int tupleIndex;
-    bool shouldCheckFurther;
-    int rowIndex;
+    size_t build_size_hint_;
+    bool bloom_filter_pushdown_;
+    bool bloom_filter_pushed_;         ///< Whether right_ accepted bloom_filter_
+    BlockedBloomFilter bloom_filter_;  ///< Hashes of the build side, pushed down to right_
+    std::vector<hash_t> build_hashes_; ///< Build-side hashes kept to fill bloom_filter_
 
+    // Matches of the current probe tuple still to emit, carried across Next/NextBatch calls
+    SimpleHashJoinHashTable::BucketCursor match_;
+    TupleBatch probeBatch;            ///< Current batch of probe-side tuples
+    size_t probeBatchPos;             ///< Next probe tuple to look up
 };
\ No newline at end of file
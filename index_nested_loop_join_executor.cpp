@@ -0,0 +1,51 @@
+#include "../include/index_nested_loop_join_executor.h"
+
+#include "../include/table_index.h"
+
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(Table *inner_table, TableIndex *index,
+                                                         AbstractExecutor *right_child_executor,
+                                                         const std::string &outer_key)
+    : inner_table_(inner_table),
+      index_(index),
+      right_(right_child_executor),
+      column_(TupleColumn::ID),
+      valid_key_(ParseTupleColumn(outer_key, &column_)),
+      inner_row_(NO_NEXT_ROW) {
+    // the index is on the integer "id", a string key can never match it
+    if (valid_key_ && column_ == TupleColumn::VAL2) {
+        std::cout << "ERROR: Wrong Type For Key: " << outer_key << std::endl;
+        valid_key_ = false;
+    }
+}
+
+void IndexNestedLoopJoinExecutor::Init() {
+    inner_row_ = NO_NEXT_ROW;
+    right_->Init();
+}
+
+bool IndexNestedLoopJoinExecutor::Next(Tuple *tuple) {
+    const Tuple *inner_tuple;
+    if (!NextRef(&inner_tuple)) return false;
+    *tuple = *inner_tuple;
+    return true;
+}
+
+bool IndexNestedLoopJoinExecutor::NextRef(const Tuple **tuple) {
+    if (!valid_key_) return false;
+    for (;;) {
+        // produce every inner tuple with the key of the current outer tuple
+        while (inner_row_ != NO_NEXT_ROW) {
+            const Tuple *inner_tuple = ResolveRecordPointer(inner_table_, RecordPointer(0, inner_row_));
+            inner_row_ = index_->next_row[inner_row_];
+            if (inner_tuple != NULL) {
+                *tuple = inner_tuple;
+                return true;
+            }
+        }
+        const Tuple *outer_tuple;
+        if (!right_->NextRef(&outer_tuple)) return false;
+        KeyType key = column_ == TupleColumn::ID ? outer_tuple->id : outer_tuple->val1;
+        RecordPointer pointer;
+        if (index_->tree.GetValue(key, pointer)) inner_row_ = pointer.record_id;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+#include "abstract_executor.h"
+#include "storage.h"
+#include "table_index.h"
+#include "tuple_column.h"
+
+/**
+ * IndexNestedLoopJoinExecutor joins an indexed inner table with an outer
+ * (right) child executor. The inner table is indexed on "id" by a TableIndex
+ * (see BuildTableIndex); for each outer tuple the index is probed with the
+ * outer join key instead of scanning the inner table, so a join costs
+ * O(N log M) instead of O(N*M).
+ *
+ * Like NestedLoopJoinExecutor, every matching inner tuple is produced once
+ * per matching outer tuple, in outer order and then in inner table order.
+ * Inner tuples sharing an id are found through the duplicate chain of the
+ * TableIndex.
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new index nested loop join executor.
+   * @param inner_table the inner (left) table
+   * @param index the index of inner_table on "id"
+   * @param right_child_executor the right child executor (outer table)
+   * @param outer_key the outer attribute matched against the inner "id", "id" or "val1"
+   */
+  IndexNestedLoopJoinExecutor(Table *inner_table, TableIndex *index,
+                              AbstractExecutor *right_child_executor,
+                              const std::string &outer_key = "id");
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from join.
+   * @param tuple the next inner tuple that matches an outer tuple
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /**
+   * Yield a pointer to the next matching inner tuple without copying it.
+   * @param tuple set to the next inner tuple that matches an outer tuple
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextRef(const Tuple **tuple) override;
+
+ private:
+  Table *inner_table_;
+  TableIndex *index_;
+  AbstractExecutor *right_;   ///< Pointer to the right child executor (outer table).
+  TupleColumn column_;        ///< Outer join key, resolved once in the constructor.
+  bool valid_key_;
+  int inner_row_;             ///< Next inner row matching the current outer tuple, or NO_NEXT_ROW.
+};
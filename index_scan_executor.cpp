@@ -0,0 +1,44 @@
+#include "../include/index_scan_executor.h"
+
+#include "../include/table_index.h"
+
+IndexScanExecutor::IndexScanExecutor(Table *table, TableIndex *index, const KeyType &key)
+    : table_(table), index_(index), key_start_(key), key_end_(key), point_lookup_(true), row_(NO_NEXT_ROW){};
+
+IndexScanExecutor::IndexScanExecutor(Table *table, TableIndex *index, const KeyType &key_start,
+                                     const KeyType &key_end)
+    : table_(table), index_(index), key_start_(key_start), key_end_(key_end), point_lookup_(false), row_(NO_NEXT_ROW){};
+
+void IndexScanExecutor::Init() {
+  row_ = NO_NEXT_ROW;
+  if (point_lookup_) {
+    RecordPointer pointer;
+    if (index_->tree.GetValue(key_start_, pointer)) row_ = pointer.record_id;
+  } else {
+    cursor_ = index_->tree.Scan(key_start_, key_end_);
+  }
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple) {
+  const Tuple *curr_tuple;
+  if (!NextRef(&curr_tuple)) return false;
+  *tuple = *curr_tuple;
+  return true;
+}
+
+bool IndexScanExecutor::NextRef(const Tuple **tuple) {
+  for (;;) {
+    // produce every row of the current key before moving to the next key
+    while (row_ != NO_NEXT_ROW) {
+      const Tuple *curr_tuple = ResolveRecordPointer(table_, RecordPointer(0, row_));
+      row_ = index_->next_row[row_];
+      if (curr_tuple != NULL) {
+        *tuple = curr_tuple;
+        return true;
+      }
+    }
+    if (point_lookup_ || cursor_.IsEnd()) return false;
+    row_ = cursor_.Value().record_id;
+    ++cursor_;
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "abstract_executor.h"
+#include "storage.h"
+#include "table_index.h"
+#include "tuple_column.h"
+
+/**
+ * The IndexScanExecutor executes a scan of a table through its TableIndex on
+ * "id" (see BuildTableIndex). Only the tuples whose id is equal to
+ * a key, or within a key range, are fetched from the table, in id order and
+ * in table order among equal ids.
+ * A range is streamed from the leaf chain, so the scan needs constant memory
+ * and stops at the end of the range.
+ */
+class IndexScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates an index scan producing the tuple whose id equals key.
+   * @param table the indexed table
+   * @param index the index of table on "id"
+   * @param key the id to look up
+   */
+  IndexScanExecutor(Table *table, TableIndex *index, const KeyType &key);
+
+  /**
+   * Creates an index scan producing the tuples whose id is in [key_start, key_end).
+   * @param table the indexed table
+   * @param index the index of table on "id"
+   * @param key_start the first id of the range
+   * @param key_end the end of the range, not included
+   */
+  IndexScanExecutor(Table *table, TableIndex *index, const KeyType &key_start, const KeyType &key_end);
+
+  /** Initialize the index scan, positioning it on the first matching key */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the index scan.
+   * @param tuple the next tuple produced by scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /**
+   * Yield a pointer to the next tuple in the table without copying it.
+   * @param tuple set to the next tuple of the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextRef(const Tuple **tuple) override;
+
+  /** @return `true` for "id", the tuples are produced in index order */
+  bool IsSortedOn(TupleColumn column) const override { return column == TupleColumn::ID; }
+
+ private:
+  Table *table_;
+  TableIndex *index_;
+  KeyType key_start_;
+  KeyType key_end_;
+  bool point_lookup_;       ///< Whether the scan is an equality lookup of key_start_.
+  int row_;                 ///< Next row with the current key, or NO_NEXT_ROW.
+  RangeCursor cursor_;      ///< Position of the range scan in the index.
+};
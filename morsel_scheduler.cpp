@@ -0,0 +1,101 @@
+#include "../include/morsel_scheduler.h"
+
+#include <algorithm>
+
+MorselScheduler::MorselScheduler(size_t num_threads, size_t morsel_size)
+    : num_threads_(num_threads),
+      morsel_size_(std::max<size_t>(morsel_size, 1)),
+      run_count_(0),
+      busy_workers_(0),
+      shutdown_(false),
+      task_(NULL),
+      run_rows_(0),
+      run_morsel_size_(0),
+      run_workers_(0) {
+    if (num_threads_ == 0) num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<MorselQueue>(num_threads_).swap(queues_);
+}
+
+MorselScheduler::~MorselScheduler() {
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        shutdown_ = true;
+    }
+    run_ready_.notify_all();
+    for (size_t i = 0; i < workers_.size(); i++) {
+        workers_[i].join();
+    }
+}
+
+void MorselScheduler::Run(size_t num_rows, size_t morsel_size, const MorselTask &task) {
+    morsel_size = std::max<size_t>(morsel_size, 1);
+    const size_t num_morsels = (num_rows + morsel_size - 1) / morsel_size;
+    if (num_morsels == 0) return;
+    const size_t num_workers = std::min(num_threads_, num_morsels);
+    if (num_workers > 1 && workers_.empty()) startWorkers();
+
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        // Give every worker an equal contiguous run of morsels to start with
+        for (size_t worker = 0; worker < num_workers; worker++) {
+            queues_[worker].front = num_morsels * worker / num_workers;
+            queues_[worker].back = num_morsels * (worker + 1) / num_workers;
+        }
+        task_ = &task;
+        run_rows_ = num_rows;
+        run_morsel_size_ = morsel_size;
+        run_workers_ = num_workers;
+        busy_workers_ = workers_.size();
+        run_count_++;
+    }
+    run_ready_.notify_all();
+
+    drainMorsels(0);
+
+    std::unique_lock<std::mutex> guard(latch_);
+    run_done_.wait(guard, [this] { return busy_workers_ == 0; });
+    task_ = NULL;
+}
+
+void MorselScheduler::startWorkers() {
+    workers_.reserve(num_threads_ - 1);
+    for (size_t worker = 1; worker < num_threads_; worker++) {
+        workers_.emplace_back(&MorselScheduler::workerLoop, this, worker);
+    }
+}
+
+void MorselScheduler::workerLoop(size_t worker) {
+    uint64_t seen_runs = 0;
+    std::unique_lock<std::mutex> guard(latch_);
+    for (;;) {
+        run_ready_.wait(guard, [this, seen_runs] { return shutdown_ || run_count_ != seen_runs; });
+        if (shutdown_) return;
+        seen_runs = run_count_;
+        // Workers without morsels of their own still count off, the run waits for all
+        if (worker < run_workers_) {
+            guard.unlock();
+            drainMorsels(worker);
+            guard.lock();
+        }
+        if (--busy_workers_ == 0) run_done_.notify_one();
+    }
+}
+
+void MorselScheduler::drainMorsels(size_t worker) {
+    const size_t num_workers = run_workers_;
+    for (;;) {
+        size_t morsel = 0;
+        bool found = false;
+        for (size_t victim = 0; !found && victim < num_workers; victim++) {
+            MorselQueue &queue = queues_[(worker + victim) % num_workers];
+            std::lock_guard<std::mutex> guard(queue.latch);
+            if (queue.front == queue.back) continue;
+            // pop our own morsels from the front, steal from the back of others
+            morsel = victim == 0 ? queue.front++ : --queue.back;
+            found = true;
+        }
+        if (!found) return;
+        const size_t begin = morsel * run_morsel_size_;
+        (*task_)(worker, morsel, begin, std::min(begin + run_morsel_size_, run_rows_));
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Default number of rows handed to a worker at a time. */
+static const size_t DEFAULT_MORSEL_SIZE = 10000;
+
+/**
+ * The MorselScheduler runs a task over a row range in parallel.
+ * The range is split into morsels of morsel_size rows. Each worker starts
+ * with its own contiguous run of morsels and, once that is drained, steals
+ * morsels from the back of the other workers' runs, so skewed morsels do
+ * not leave threads idle.
+ *
+ * The worker threads are started by the first Run() and then wait for the
+ * next one, so repeated runs do not pay for creating threads.
+ */
+class MorselScheduler {
+ public:
+  /**
+   * Called as task(worker, morsel, begin, end) for rows [begin, end) of
+   * morsel number morsel.
+   */
+  typedef std::function<void(size_t, size_t, size_t, size_t)> MorselTask;
+
+  /**
+   * Creates a new morsel scheduler.
+   * @param num_threads number of workers, 0 to use every hardware thread
+   * @param morsel_size number of rows per morsel
+   */
+  explicit MorselScheduler(size_t num_threads = 0, size_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /** Stops and joins the worker threads. */
+  ~MorselScheduler();
+
+  MorselScheduler(const MorselScheduler &) = delete;
+  MorselScheduler &operator=(const MorselScheduler &) = delete;
+
+  /** @return the number of workers a Run() uses */
+  size_t NumThreads() const { return num_threads_; }
+
+  /** @return the number of rows per morsel */
+  size_t MorselSize() const { return morsel_size_; }
+
+  /** @return the number of morsels a range of num_rows rows is split into */
+  size_t NumMorsels(size_t num_rows) const { return (num_rows + morsel_size_ - 1) / morsel_size_; }
+
+  /**
+   * Run task once per morsel of [0, num_rows) and wait for all of them.
+   * The calling thread is used as worker 0. Calls with the same worker id
+   * never run concurrently, so per-worker state needs no locking. A task must
+   * not call Run() on the same scheduler.
+   * @param num_rows number of rows in the range
+   * @param task the task to run for every morsel
+   */
+  void Run(size_t num_rows, const MorselTask &task) { Run(num_rows, morsel_size_, task); }
+
+  /**
+   * Run task over [0, num_rows) with morsels of a different size than the
+   * scheduler's own, on the same workers.
+   * @param num_rows number of rows in the range
+   * @param morsel_size number of rows per morsel of this run
+   * @param task the task to run for every morsel
+   */
+  void Run(size_t num_rows, size_t morsel_size, const MorselTask &task);
+
+ private:
+  // Morsels [front, back) still owned by one worker. The owner pops from the
+  // front, thieves take from the back.
+  struct MorselQueue {
+    std::mutex latch;
+    size_t front;
+    size_t back;
+  };
+
+  /** Start the num_threads - 1 workers that help the calling thread. */
+  void startWorkers();
+
+  /** Body of a worker thread: wait for a run, take part in it, repeat. */
+  void workerLoop(size_t worker);
+
+  /** Run morsels of the current run as worker until none is left. */
+  void drainMorsels(size_t worker);
+
+  size_t num_threads_;
+  size_t morsel_size_;
+  std::vector<std::thread> workers_;
+  std::vector<MorselQueue> queues_;  ///< One per worker, reset by every Run()
+
+  std::mutex latch_;                      ///< Protects the fields below
+  std::condition_variable run_ready_;     ///< Signals a new run or shutdown to the workers
+  std::condition_variable run_done_;      ///< Signals the last worker finishing a run
+  uint64_t run_count_;                    ///< Number of runs started so far
+  size_t busy_workers_;                   ///< Workers still inside the current run
+  bool shutdown_;
+
+  // The current run, set before run_count_ is increased
+  const MorselTask *task_;
+  size_t run_rows_;
+  size_t run_morsel_size_;
+  size_t run_workers_;  ///< Workers that own morsels in the current run
+};
@@ -5,20 +5,23 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(
     AbstractExecutor *right_child_executor, const std::string join_key)
     : left_(left_child_executor),
       right_(right_child_executor),
-      join_key_(join_key){};
+      join_key_(join_key),
+      column_(TupleColumn::ID),
+      valid_key_(ParseTupleColumn(join_key, &column_)){};
 
 void NestedLoopJoinExecutor::Init() {
     outerTuplePresent = true;
     innerTuplePresent = false;
+    batchOuterPresent = false;
+    innerBatch.Clear();
+    innerBatchPos = 0;
     left_->Init();
     right_->Init();
 }
 
 // Check if key is same while joining in tables
 bool NestedLoopJoinExecutor::checkKeyIsSameInJoin(const Tuple *inner_tuple, const Tuple *outer_tuple) {
-    return (("id" == join_key_ && inner_tuple->id == outer_tuple->id) ||
-            ("val1" == join_key_ && inner_tuple->val1 == outer_tuple->val1) ||
-            ("val2" == join_key_ && inner_tuple->val2 == outer_tuple->val2));
+    return valid_key_ && KeysEqual(*inner_tuple, *outer_tuple, column_);
 }
 
 // Extract Next tuple. If tuple is present -> return true
@@ -31,13 +34,13 @@ bool NestedLoopJoinExecutor::Next(Tuple *tuple) {
   if(outerTuplePresent) {
       // If the right table has next tuple
       while (right_->Next(tuple)) {
-          Tuple innerTableTuple;
+          const Tuple *innerTableTuple;
 
-          // If the left table has next tuple
-          while (left_->Next(&innerTableTuple)) {
+          // If the left table has next tuple, view it in place and only copy matches
+          while (left_->NextRef(&innerTableTuple)) {
               // check if the table row is same after the join
-              if (checkKeyIsSameInJoin(&innerTableTuple, tuple)) {
-                  *tuple = Tuple(innerTableTuple);
+              if (checkKeyIsSameInJoin(innerTableTuple, tuple)) {
+                  *tuple = *innerTableTuple;
                   outerTuplePresent = false;
                   innerTuplePresent = true;
                   return true;
@@ -51,10 +54,10 @@ bool NestedLoopJoinExecutor::Next(Tuple *tuple) {
       innerTuplePresent = false;
   } else {
       // If tuple is present in left Child
-      Tuple innerTableTuple = *tuple;
-      while (left_->Next(&innerTableTuple)) {
-          if (checkKeyIsSameInJoin(&innerTableTuple, tuple)) {
-              *tuple = Tuple(innerTableTuple);
+      const Tuple *innerTableTuple;
+      while (left_->NextRef(&innerTableTuple)) {
+          if (checkKeyIsSameInJoin(innerTableTuple, tuple)) {
+              *tuple = *innerTableTuple;
               outerTuplePresent = false;
               innerTuplePresent = true;
               return true;
@@ -66,4 +69,34 @@ bool NestedLoopJoinExecutor::Next(Tuple *tuple) {
       if (Next(tuple)) return true;
   }
   return false;
-}
\ No newline at end of file
+}
+
+// Fill the batch with matches. For each outer tuple the inner table is
+// consumed batch by batch; when the inner table runs out it is re-initiated
+// and the next outer tuple is pulled.
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    while (!batch->IsFull()) {
+        if (!batchOuterPresent) {
+            if (!right_->Next(&batchOuterTuple)) break;
+            batchOuterPresent = true;
+        }
+        if (innerBatchPos == innerBatch.Size()) {
+            innerBatchPos = 0;
+            if (!left_->NextBatch(&innerBatch)) {
+                // Re-initiate the left database index for the next outer tuple
+                left_->Init();
+                batchOuterPresent = false;
+                continue;
+            }
+        }
+        while (innerBatchPos < innerBatch.Size() && !batch->IsFull()) {
+            const Tuple &innerTableTuple = innerBatch[innerBatchPos++];
+            if (checkKeyIsSameInJoin(&innerTableTuple, &batchOuterTuple)) {
+                *batch->Slot() = innerTableTuple;
+                batch->Commit();
+            }
+        }
+    }
+    return !batch->IsEmpty();
+}
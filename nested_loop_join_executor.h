@@ -4,6 +4,7 @@
 
 #include "abstract_executor.h"
 #include "storage.h"
+#include "tuple_column.h"
 
 /**
  * In our implementation of the NestedLoopJoinExecutor, we perform an inner join between
@@ -51,6 +52,14 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple) override;
 
+  /**
+   * Yield the next batch of joined tuples. The inner (left) table is pulled
+   * batch by batch, so a match only costs a copy into the output batch.
+   * @param batch the batch to fill with the next inner tuples that match
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** 
    * Checks if two tuples match on the join key.
    * @param inner_tuple the inner tuple from the left table
@@ -63,6 +72,14 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   AbstractExecutor *left_;    ///< Pointer to the left child executor (inner table).
   AbstractExecutor *right_;   ///< Pointer to the right child executor (outer table).
   std::string join_key_;      ///< Attribute name on which to perform the join.
+  TupleColumn column_;        ///< join_key_ resolved once, in the constructor.
+  bool valid_key_;            ///< Whether join_key_ names an attribute.
   bool outerTuplePresent;
   bool innerTuplePresent;
+
+  // State of the batch interface, carried across NextBatch calls
+  Tuple batchOuterTuple;      ///< Current outer tuple being joined.
+  bool batchOuterPresent;     ///< Whether batchOuterTuple holds a valid tuple.
+  TupleBatch innerBatch;      ///< Current batch of inner tuples.
+  size_t innerBatchPos;       ///< Position of the next inner tuple to compare.
 };
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/** Alignment of every node slot, one cache line. */
+static const size_t NODE_POOL_ALIGNMENT = 64;
+
+/** Bytes requested from the system at a time for new node slots. */
+static const size_t NODE_POOL_SLAB_BYTES = 64 * 1024;
+
+/**
+ * Slab allocator for one kind of B+ tree node.
+ *
+ * Nodes are carved out of large cache-line-aligned slabs instead of being
+ * allocated one by one, so each node starts on its own cache line and
+ * siblings created together sit next to each other in memory. Freed nodes go
+ * to a free list that later allocations reuse first. Reset releases every
+ * slab at once without visiting the nodes, which is why T must be trivially
+ * destructible.
+ */
+template <typename T>
+class NodePool
+{
+public:
+    NodePool() : free_list(NULL), next_slot(NULL), slab_end(NULL), live_nodes(0){};
+
+    ~NodePool() { Reset(); }
+
+    /**
+     * Creates a node, reusing a freed slot if there is one.
+     * @return the default constructed node
+     */
+    T *Allocate()
+    {
+        void *slot;
+        if (free_list != NULL) {
+            slot = free_list;
+            free_list = free_list->next;
+        } else {
+            if (next_slot == slab_end) grow();
+            slot = next_slot;
+            next_slot += SLOT_SIZE;
+        }
+        live_nodes++;
+        return new (slot) T();
+    }
+
+    /**
+     * Returns a node allocated by this pool to the free list.
+     * @param node the node, may be NULL
+     */
+    void Free(T *node)
+    {
+        if (node == NULL) return;
+        FreeSlot *slot = reinterpret_cast<FreeSlot *>(node);
+        slot->next = free_list;
+        free_list = slot;
+        live_nodes--;
+    }
+
+    /** Releases every node at once, returning the slabs to the system. */
+    void Reset()
+    {
+        for (size_t index = 0; index < slabs.size(); index++) {
+            free(slabs[index]);
+        }
+        slabs.clear();
+        free_list = NULL;
+        next_slot = slab_end = NULL;
+        live_nodes = 0;
+    }
+
+    /** @return the bytes held by the pool's slabs */
+    size_t MemoryUsage() const { return slabs.size() * SLOT_SIZE * SLOTS_PER_SLAB; }
+
+    /** @return the number of nodes allocated and not freed */
+    size_t LiveNodes() const { return live_nodes; }
+
+private:
+    static_assert(std::is_trivially_destructible<T>::value, "Reset does not run node destructors");
+
+    // A freed slot holds the link to the next freed slot
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    static const size_t SLOT_SIZE = (sizeof(T) + NODE_POOL_ALIGNMENT - 1) / NODE_POOL_ALIGNMENT * NODE_POOL_ALIGNMENT;
+    static const size_t SLOTS_PER_SLAB = SLOT_SIZE >= NODE_POOL_SLAB_BYTES ? 1 : NODE_POOL_SLAB_BYTES / SLOT_SIZE;
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    // Starts a new slab for the next allocations
+    void grow()
+    {
+        void *slab;
+        if (posix_memalign(&slab, NODE_POOL_ALIGNMENT, SLOT_SIZE * SLOTS_PER_SLAB) != 0) {
+            throw std::bad_alloc();
+        }
+        slabs.push_back(slab);
+        next_slot = static_cast<char *>(slab);
+        slab_end = next_slot + SLOT_SIZE * SLOTS_PER_SLAB;
+    }
+
+    std::vector<void *> slabs;
+    FreeSlot *free_list;
+    char *next_slot;    // next never used slot of the current slab
+    char *slab_end;
+    size_t live_nodes;
+};
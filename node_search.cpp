@@ -0,0 +1,89 @@
+#include "../include/node_search.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NODE_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Number of keys below key (inclusive: not above key). The keys are sorted,
+// so this is the position of the bound inside the window.
+template <bool inclusive>
+int countScalar(const int *keys, int n, int key) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        count += inclusive ? keys[i] <= key : keys[i] < key;
+    }
+    return count;
+}
+
+#ifdef NODE_SEARCH_X86
+template <bool inclusive>
+__attribute__((target("avx2,popcnt")))
+int countAvx2(const int *keys, int n, int key) {
+    const __m256i pivot = _mm256_set1_epi32(key);
+    int count = 0, i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i block = _mm256_loadu_si256((const __m256i *)(keys + i));
+        // keys below the pivot, or for the inclusive count keys not above it
+        const __m256i cmp = inclusive ? _mm256_cmpgt_epi32(block, pivot) : _mm256_cmpgt_epi32(pivot, block);
+        const int bits = __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+        count += inclusive ? 8 - bits : bits;
+    }
+    return count + countScalar<inclusive>(keys + i, n - i, key);
+}
+#endif
+
+typedef int (*CountKeysFn)(const int *, int, int);
+
+struct NodeSearchImpl {
+    CountKeysFn count_less;
+    CountKeysFn count_less_equal;
+    const char *isa;
+};
+
+// Picks the widest instruction set the running CPU supports
+NodeSearchImpl resolveNodeSearch() {
+#ifdef NODE_SEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        NodeSearchImpl impl = {countAvx2<false>, countAvx2<true>, "avx2"};
+        return impl;
+    }
+#endif
+    NodeSearchImpl impl = {countScalar<false>, countScalar<true>, "scalar"};
+    return impl;
+}
+
+const NodeSearchImpl &nodeSearchImpl() {
+    static const NodeSearchImpl impl = resolveNodeSearch();
+    return impl;
+}
+
+}  // namespace
+
+int NodeLowerBound(const int *keys, int key_num, const int &key) {
+    const int *base = keys;
+    int n = key_num;
+    // narrow down to a window whose keys before are all below key and after are not
+    while (n > NODE_SEARCH_WINDOW) {
+        int half = n / 2;
+        base = (base[half] < key) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - keys) + nodeSearchImpl().count_less(base, n, key);
+}
+
+int NodeUpperBound(const int *keys, int key_num, const int &key) {
+    const int *base = keys;
+    int n = key_num;
+    while (n > NODE_SEARCH_WINDOW) {
+        int half = n / 2;
+        base = !(key < base[half]) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - keys) + nodeSearchImpl().count_less_equal(base, n, key);
+}
+
+const char *NodeSearchIsa() { return nodeSearchImpl().isa; }
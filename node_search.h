@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * Key search inside a B+ tree node. Every descent of BPlusTree goes through
+ * these functions instead of scanning keys[] with a branch per key.
+ *
+ * The generic versions run a branchless binary search, which works for any
+ * KeyType ordered by operator<. The overloads for int keys binary search
+ * down to a window of NODE_SEARCH_WINDOW keys and then count the window with
+ * an AVX2 compare-and-movemask when the CPU supports it.
+ */
+
+/** Number of keys the int searches count linearly after the binary search. */
+static const int NODE_SEARCH_WINDOW = 16;
+
+/**
+ * Position of the first key that is not less than key.
+ * @param keys the sorted keys of a node
+ * @param key_num number of keys
+ * @param key the key to search for
+ * @return a position in [0, key_num]
+ */
+template <typename K>
+inline int NodeLowerBound(const K *keys, int key_num, const K &key) {
+    if (key_num == 0) return 0;
+    const K *base = keys;
+    int n = key_num;
+    // the select compiles to a conditional move, there is no branch to mispredict
+    while (n > 1) {
+        int half = n / 2;
+        base = (base[half] < key) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - keys) + (*base < key);
+}
+
+/**
+ * Position of the first key that is greater than key. For an internal node,
+ * this is the child to descend into.
+ * @param keys the sorted keys of a node
+ * @param key_num number of keys
+ * @param key the key to search for
+ * @return a position in [0, key_num]
+ */
+template <typename K>
+inline int NodeUpperBound(const K *keys, int key_num, const K &key) {
+    if (key_num == 0) return 0;
+    const K *base = keys;
+    int n = key_num;
+    while (n > 1) {
+        int half = n / 2;
+        base = !(key < base[half]) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - keys) + !(key < *base);
+}
+
+/** NodeLowerBound for int keys, counting the last window with SIMD. */
+int NodeLowerBound(const int *keys, int key_num, const int &key);
+
+/** NodeUpperBound for int keys, counting the last window with SIMD. */
+int NodeUpperBound(const int *keys, int key_num, const int &key);
+
+/** @return the name of the instruction set the int searches use: "avx2" or "scalar" */
+const char *NodeSearchIsa();
@@ -0,0 +1,7 @@
+#pragma once
+
+// Key type of the B+ tree index
+typedef int KeyType;
+
+// Node sizes of the B+ tree are set through BPLUS_NODE_BYTES in
+// b_plus_tree.h. Defining MAX_FANOUT here fixes the fanout instead.
@@ -0,0 +1,40 @@
+#include "../include/parallel_aggregation_executor.h"
+
+#include <vector>
+
+ParallelAggregationExecutor::ParallelAggregationExecutor(Table *table, AggregationType aggr_type,
+                                                         FilterPredicate *predicate, size_t num_threads,
+                                                         size_t morsel_size)
+    : aggr_type_(aggr_type),
+      scan_(table, predicate, num_threads, morsel_size),
+      done_(false){};
+
+void ParallelAggregationExecutor::Init() {
+    state_ = AggregationState();
+    done_ = false;
+}
+
+bool ParallelAggregationExecutor::Next(Tuple *tuple) {
+    if (done_) return false;
+    done_ = true;
+
+    // One partial state per worker; a worker never runs two morsels at once
+    std::vector<AggregationState> partials(scan_.NumThreads());
+    scan_.ForEachMorsel([&partials](size_t worker, const std::vector<const Tuple *> &tuples) {
+        // fold into a local state first, the partials of the workers share cache lines
+        AggregationState morselState;
+        for (size_t i = 0; i < tuples.size(); i++) {
+            morselState.Update(tuples[i]->val1);
+        }
+        partials[worker].Merge(morselState);
+    });
+    for (size_t worker = 0; worker < partials.size(); worker++) {
+        state_.Merge(partials[worker]);
+    }
+
+    if (state_.count > 0) {
+        FillAggregationResult(state_, aggr_type_, tuple);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "abstract_executor.h"
+#include "aggregation_executor.h"
+#include "filter_seq_scan_executor.h"
+#include "morsel_scheduler.h"
+#include "parallel_seq_scan_executor.h"
+#include "storage.h"
+
+/**
+ * The ParallelAggregationExecutor computes COUNT/SUM/MIN/MAX over "val1" of a
+ * table, optionally filtered by a predicate, on a worker pool.
+ * It runs as the downstream operator of a ParallelSeqScanExecutor: each worker
+ * folds the tuples of the morsels it filtered into a thread-local
+ * AggregationState, and the partial states are merged once every morsel is
+ * done. The result matches an
+ * AggregationExecutor over a (Filter)SeqScanExecutor of the same table.
+ */
+class ParallelAggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Constructor for ParallelAggregationExecutor.
+   * @param table The table to aggregate.
+   * @param aggr_type The type of aggregation operation to be performed.
+   * @param predicate Optional filter on "val1", NULL to aggregate every tuple.
+   * @param num_threads Number of workers, 0 to use every hardware thread.
+   * @param morsel_size Number of rows handed to a worker at a time.
+   */
+  ParallelAggregationExecutor(Table *table, AggregationType aggr_type, FilterPredicate *predicate = NULL,
+                              size_t num_threads = 0, size_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /** Initialize the aggregation operation. */
+  void Init() override;
+
+  /**
+   * Yield the result of the aggregation.
+   * @param tuple The result tuple, with the result in the "val1" attribute.
+   * @return `true` if a tuple was produced, `false` if no tuple qualified or the result was already produced.
+   */
+  bool Next(Tuple *tuple) override;
+
+  /** @return the 64-bit result of the last aggregation, which "val1" may not be able to hold. */
+  int64_t GetResult() const { return state_.Result(aggr_type_); }
+
+ private:
+  AggregationType aggr_type_;    ///< The type of aggregation operation.
+  ParallelSeqScanExecutor scan_; ///< Parallel scan feeding the workers.
+  AggregationState state_;       ///< Merged state of the last aggregation.
+  bool done_;                    ///< Whether the result was already produced.
+};
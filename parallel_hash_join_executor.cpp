@@ -0,0 +1,89 @@
+#include "../include/parallel_hash_join_executor.h"
+
+namespace {
+
+const int MAX_PARTITION_BITS = 10;
+
+}  // namespace
+
+ParallelHashJoinExecutor::ParallelHashJoinExecutor(Table *left_table, Table *right_table,
+                                                   SimpleHashFunction *hash_fn, size_t num_threads,
+                                                   size_t morsel_size)
+    : left_table_(left_table),
+      right_table_(right_table),
+      hash_fn_(hash_fn),
+      scheduler_(num_threads, morsel_size),
+      partition_bits_(0),
+      result_morsel_(0),
+      result_pos_(0) {
+    // enough partitions that the build phase keeps every worker busy
+    while (partition_bits_ < MAX_PARTITION_BITS && ((size_t)1 << partition_bits_) < 8 * scheduler_.NumThreads()) {
+        partition_bits_++;
+    }
+}
+
+void ParallelHashJoinExecutor::Init() {
+    const size_t num_partitions = (size_t)1 << partition_bits_;
+    std::vector<Tuple>::iterator left_rows = left_table_->Begin();
+    std::vector<Tuple>::iterator right_rows = right_table_->Begin();
+    const size_t num_left = left_table_->End() - left_rows;
+    const size_t num_right = right_table_->End() - right_rows;
+
+    // (1) hash the left table and stage (hash, row) pairs per morsel and partition
+    typedef std::vector<std::pair<hash_t, uint32_t>> StagedRows;
+    std::vector<std::vector<StagedRows>> staged(scheduler_.NumMorsels(num_left),
+                                                std::vector<StagedRows>(num_partitions));
+    scheduler_.Run(num_left, [&](size_t, size_t morsel, size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            const hash_t h = hash_fn_->GetHash(left_rows[row]);
+            staged[morsel][partitionOf(h)].push_back(std::make_pair(h, (uint32_t)row));
+        }
+    });
+
+    // (2) fill every partition from a single worker, in morsel order
+    partitions_.assign(num_partitions, SimpleHashJoinHashTable());
+    scheduler_.Run(num_partitions, 1, [&](size_t, size_t partition, size_t, size_t) {
+        size_t num_rows = 0;
+        for (size_t morsel = 0; morsel < staged.size(); morsel++) num_rows += staged[morsel][partition].size();
+        SimpleHashJoinHashTable &table = partitions_[partition];
+        table.Reserve(num_rows);
+        for (size_t morsel = 0; morsel < staged.size(); morsel++) {
+            const StagedRows &rows = staged[morsel][partition];
+            for (size_t i = 0; i < rows.size(); i++) {
+                table.Insert(rows[i].first, left_rows[rows[i].second]);
+            }
+        }
+    });
+
+    // (3) probe the right table, collecting matches per morsel
+    results_.assign(scheduler_.NumMorsels(num_right), std::vector<const Tuple *>());
+    scheduler_.Run(num_right, [&](size_t, size_t morsel, size_t begin, size_t end) {
+        std::vector<const Tuple *> &matches = results_[morsel];
+        for (size_t row = begin; row < end; row++) {
+            const hash_t h = hash_fn_->GetHash(right_rows[row]);
+            for (SimpleHashJoinHashTable::BucketCursor it = partitions_[partitionOf(h)].Find(h); !it.IsEnd(); ++it) {
+                matches.push_back(&*it);
+            }
+        }
+    });
+
+    result_morsel_ = 0;
+    result_pos_ = 0;
+}
+
+bool ParallelHashJoinExecutor::Next(Tuple *tuple) {
+    const Tuple *match;
+    if (!NextRef(&match)) return false;
+    *tuple = *match;
+    return true;
+}
+
+bool ParallelHashJoinExecutor::NextRef(const Tuple **tuple) {
+    while (result_morsel_ < results_.size() && result_pos_ == results_[result_morsel_].size()) {
+        result_morsel_++;
+        result_pos_ = 0;
+    }
+    if (result_morsel_ == results_.size()) return false;
+    *tuple = results_[result_morsel_][result_pos_++];
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "hash_join_executor.h"
+#include "morsel_scheduler.h"
+#include "storage.h"
+
+/**
+ * ParallelHashJoinExecutor executes a hash join between two tables on a
+ * worker pool. It produces the same tuples, in the same order, as a
+ * HashJoinExecutor over sequential scans of the two tables.
+ *
+ * The hash table is split into partitions on the top hash bits, so it can be
+ * built without any locking:
+ * (1) workers hash morsels of the left table and stage (hash, row) pairs per
+ *     morsel and partition,
+ * (2) each partition's SimpleHashJoinHashTable is then filled by a single
+ *     worker, in morsel order,
+ * (3) workers probe morsels of the right table against the read-only tables
+ *     and record pointers to the matches in per-morsel output buffers.
+ * Next() walks the output buffers in morsel order.
+ */
+class ParallelHashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new parallel hash join executor.
+   * @param left_table the table used to build the hash table
+   * @param right_table the table used to probe the hash table
+   * @param hash_fn the hash function of the join key
+   * @param num_threads number of workers, 0 to use every hardware thread
+   * @param morsel_size number of rows handed to a worker at a time
+   */
+  ParallelHashJoinExecutor(Table *left_table, Table *right_table, SimpleHashFunction *hash_fn,
+                           size_t num_threads = 0, size_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /** Initialize the join, building and probing in parallel */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from join.
+   * @param tuple the next tuple produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /**
+   * Yield a pointer to the next joined tuple, held by the join's hash table.
+   * @param tuple set to the next tuple produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextRef(const Tuple **tuple) override;
+
+ private:
+  /** @return the hash table partition of a hash */
+  size_t partitionOf(hash_t h) const { return partition_bits_ == 0 ? 0 : h >> (32 - partition_bits_); }
+
+  Table *left_table_;
+  Table *right_table_;
+  SimpleHashFunction *hash_fn_;
+  MorselScheduler scheduler_;
+  int partition_bits_;
+
+  std::vector<SimpleHashJoinHashTable> partitions_;  ///< Hash table, one per partition
+  std::vector<std::vector<const Tuple *>> results_;  ///< Matches, one buffer per right morsel
+  size_t result_morsel_;                             ///< Buffer Next() is reading from
+  size_t result_pos_;                                ///< Position in that buffer
+};
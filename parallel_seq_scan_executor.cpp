@@ -0,0 +1,102 @@
+#include "../include/parallel_seq_scan_executor.h"
+
+#include <algorithm>
+
+#include "../include/filter_kernel.h"
+
+ParallelSeqScanExecutor::ParallelSeqScanExecutor(Table *table, FilterPredicate *predicate,
+                                                 size_t num_threads, size_t morsel_size)
+    : table_(table),
+      pred_(predicate),
+      scheduler_(num_threads, morsel_size),
+      num_rows_(0),
+      next_row_(0),
+      morsel_(0),
+      morsel_pos_(0){};
+
+void ParallelSeqScanExecutor::Init() {
+  num_rows_ = table_->End() - table_->Begin();
+  next_row_ = 0;
+  morsel_ = 0;
+  morsel_pos_ = 0;
+  window_.clear();
+}
+
+bool ParallelSeqScanExecutor::Next(Tuple *tuple) {
+  const Tuple *curr_tuple;
+  if (!NextRef(&curr_tuple)) return false;
+  *tuple = *curr_tuple;
+  return true;
+}
+
+bool ParallelSeqScanExecutor::NextRef(const Tuple **tuple) {
+  // Without a predicate every row qualifies, there is nothing to do in parallel
+  if (pred_ == NULL) {
+    if (next_row_ == num_rows_) return false;
+    *tuple = &*(table_->Begin() + next_row_++);
+    return true;
+  }
+  for (;;) {
+    while (morsel_ < window_.size() && morsel_pos_ == window_[morsel_].size()) {
+      morsel_++;
+      morsel_pos_ = 0;
+    }
+    if (morsel_ < window_.size()) break;
+    if (!fillWindow()) return false;
+  }
+  *tuple = window_[morsel_][morsel_pos_++];
+  return true;
+}
+
+void ParallelSeqScanExecutor::ForEachMorsel(const MorselConsumer &consumer) {
+  std::vector<std::vector<const Tuple *>> worker_tuples(scheduler_.NumThreads());
+  scheduler_.Run(table_->End() - table_->Begin(),
+                 [this, &consumer, &worker_tuples](size_t worker, size_t, size_t begin, size_t end) {
+                   std::vector<const Tuple *> &tuples = worker_tuples[worker];
+                   tuples.clear();
+                   filterMorsel(begin, end, &tuples);
+                   if (!tuples.empty()) consumer(worker, tuples);
+                 });
+}
+
+bool ParallelSeqScanExecutor::fillWindow() {
+  if (next_row_ == num_rows_) return false;
+  const size_t base = next_row_;
+  const size_t rows = std::min(num_rows_ - base,
+                               scheduler_.NumThreads() * DEFAULT_MORSELS_PER_WORKER * scheduler_.MorselSize());
+  window_.resize(scheduler_.NumMorsels(rows));
+  for (size_t morsel = 0; morsel < window_.size(); morsel++) {
+    window_[morsel].clear();
+  }
+  scheduler_.Run(rows, [this, base](size_t, size_t morsel, size_t begin, size_t end) {
+    filterMorsel(base + begin, base + end, &window_[morsel]);
+  });
+  next_row_ = base + rows;
+  morsel_ = 0;
+  morsel_pos_ = 0;
+  return true;
+}
+
+void ParallelSeqScanExecutor::filterMorsel(size_t begin, size_t end,
+                                           std::vector<const Tuple *> *tuples) const {
+  std::vector<Tuple>::iterator rows = table_->Begin();
+  if (pred_ == NULL) {
+    for (size_t row = begin; row < end; row++) {
+      tuples->push_back(&rows[row]);
+    }
+    return;
+  }
+  int val1_block[FILTER_BLOCK_SIZE];
+  uint32_t block_selection[FILTER_BLOCK_SIZE];
+  for (size_t block = begin; block < end; block += FILTER_BLOCK_SIZE) {
+    const size_t block_rows = std::min(FILTER_BLOCK_SIZE, end - block);
+    for (size_t i = 0; i < block_rows; i++) {
+      val1_block[i] = rows[block + i].val1;
+    }
+    const size_t selected = SelectVal1(val1_block, block_rows, pred_->val, pred_->condition,
+                                       block_selection);
+    for (size_t i = 0; i < selected; i++) {
+      tuples->push_back(&rows[block + block_selection[i]]);
+    }
+  }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "filter_seq_scan_executor.h"
+#include "morsel_scheduler.h"
+#include "storage.h"
+
+/** Default number of morsels per worker that Next() filters ahead at a time. */
+static const size_t DEFAULT_MORSELS_PER_WORKER = 4;
+
+/**
+ * The ParallelSeqScanExecutor executes a morsel-driven parallel scan.
+ * The table is split into morsels that are filtered on a worker pool with
+ * the vectorized filter kernel.
+ *
+ * ForEachMorsel() is the parallel pipeline: every worker filters a morsel and
+ * hands its qualifying tuples to the downstream operator on the same thread,
+ * so nothing is collected for the whole table. Next() instead filters a window
+ * of a few morsels per worker in parallel, hands the rows out in table order
+ * and only then moves to the next window. Its output is identical to a
+ * FilterSeqScanExecutor (or a SeqScanExecutor when no predicate is given).
+ */
+class ParallelSeqScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Called by a worker with the qualifying tuples of one morsel, in table
+   * order. The vector is reused for the worker's next morsel.
+   */
+  typedef std::function<void(size_t, const std::vector<const Tuple *> &)> MorselConsumer;
+
+  /**
+   * Creates a new parallel scan.
+   * @param table the table to scan
+   * @param predicate optional filter on val1, NULL to produce every row
+   * @param num_threads number of workers, 0 to use every hardware thread
+   * @param morsel_size number of rows handed to a worker at a time
+   */
+  ParallelSeqScanExecutor(Table *table, FilterPredicate *predicate = NULL,
+                          size_t num_threads = 0, size_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /** Initialize the scan */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the parallel scan.
+   * @param tuple the next tuple produced by scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /**
+   * Yield a pointer to the next tuple in the table without copying it.
+   * @param tuple set to the next qualifying tuple
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextRef(const Tuple **tuple) override;
+
+  /**
+   * Scan the whole table on the worker pool, passing the qualifying tuples of
+   * every morsel to consumer as soon as the morsel is filtered. Does not
+   * change the position of Next().
+   * @param consumer called as consumer(worker, tuples); calls with the same
+   *                 worker id never run concurrently
+   */
+  void ForEachMorsel(const MorselConsumer &consumer);
+
+  /** @return the number of workers, and so of distinct worker ids passed to a consumer */
+  size_t NumThreads() const { return scheduler_.NumThreads(); }
+
+ private:
+  /**
+   * Filter the rows [begin, end) of the table.
+   * @param[out] tuples receives the qualifying tuples
+   */
+  void filterMorsel(size_t begin, size_t end, std::vector<const Tuple *> *tuples) const;
+
+  /**
+   * Filter the next window of morsels in parallel.
+   * @return `false` if the whole table was already filtered
+   */
+  bool fillWindow();
+
+  Table *table_;
+  FilterPredicate *pred_;
+  MorselScheduler scheduler_;
+
+  std::vector<std::vector<const Tuple *>> window_;  ///< Qualifying tuples of each morsel of the window
+  size_t num_rows_;                                 ///< Rows in the table at Init()
+  size_t next_row_;                                 ///< First row not filtered yet
+  size_t morsel_;                                   ///< Morsel of the window Next() is reading from
+  size_t morsel_pos_;                               ///< Position within the morsel
+};
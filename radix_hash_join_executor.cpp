@@ -0,0 +1,161 @@
+#include "../include/radix_hash_join_executor.h"
+
+namespace {
+
+const uint32_t NO_ROW = 0xffffffff;
+const int MAX_RADIX_BITS = 16;
+
+// Approximate per-row footprint of a partition table: the hashed row, its
+// chain link and a bucket head
+const size_t PARTITION_BYTES_PER_ROW = 16;
+
+// One stable counting-sort pass: scatter src into dst by the digit
+// (hash >> shift) & ((1 << bits) - 1), and add the digit counts to counts
+template <typename Row>
+void scatter(const Row *src, size_t n, Row *dst, int shift, int bits, std::vector<size_t> *counts) {
+    const size_t fanout = (size_t)1 << bits;
+    const hash_t mask = (hash_t)(fanout - 1);
+    std::vector<size_t> offsets(fanout + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        offsets[((src[i].hash >> shift) & mask) + 1]++;
+    }
+    for (size_t d = 0; d < fanout; d++) {
+        (*counts)[d] = offsets[d + 1];
+        offsets[d + 1] += offsets[d];
+    }
+    for (size_t i = 0; i < n; i++) {
+        dst[offsets[(src[i].hash >> shift) & mask]++] = src[i];
+    }
+}
+
+}  // namespace
+
+RadixHashJoinExecutor::RadixHashJoinExecutor(AbstractExecutor *left_child_executor,
+                                             AbstractExecutor *right_child_executor,
+                                             SimpleHashFunction *hash_fn,
+                                             int radix_bits,
+                                             int num_passes)
+    : left_(left_child_executor),
+      right_(right_child_executor),
+      hash_fn_(hash_fn),
+      requested_bits_(radix_bits < MAX_RADIX_BITS ? radix_bits : MAX_RADIX_BITS),
+      num_passes_(num_passes == 2 ? 2 : 1),
+      bits_(0),
+      bucket_mask_(0),
+      partition_(0),
+      probe_pos_(0),
+      chain_(NO_ROW),
+      probe_hash_(0) {}
+
+void RadixHashJoinExecutor::Init() {
+    build_tuples_.clear();
+    build_rows_.clear();
+    probe_rows_.clear();
+
+    const Tuple *tuple;
+    left_->Init();
+    while (left_->NextRef(&tuple)) {
+        HashedRow row = {hash_fn_->GetHash(*tuple), (uint32_t)build_tuples_.size()};
+        build_rows_.push_back(row);
+        build_tuples_.push_back(*tuple);
+    }
+    right_->Init();
+    while (right_->NextRef(&tuple)) {
+        ProbeRow row = {hash_fn_->GetHash(*tuple)};
+        probe_rows_.push_back(row);
+    }
+
+    bits_ = requested_bits_;
+    if (bits_ <= 0) {
+        bits_ = 0;
+        while (bits_ < MAX_RADIX_BITS &&
+               (build_rows_.size() >> bits_) * PARTITION_BYTES_PER_ROW > DEFAULT_RADIX_PARTITION_BYTES) {
+            bits_++;
+        }
+    }
+    partition(&build_rows_, &build_bounds_);
+    partition(&probe_rows_, &probe_bounds_);
+
+    partition_ = 0;
+    probe_pos_ = probe_bounds_[0];
+    chain_ = NO_ROW;
+    buildPartition();
+}
+
+bool RadixHashJoinExecutor::Next(Tuple *tuple) {
+    const size_t num_partitions = build_bounds_.size() - 1;
+    while (partition_ < num_partitions) {
+        const size_t build_begin = build_bounds_[partition_];
+        // emit the remaining matches of the current probe row
+        while (chain_ != NO_ROW) {
+            const HashedRow &build_row = build_rows_[build_begin + chain_];
+            chain_ = bucket_next_[chain_];
+            if (build_row.hash == probe_hash_) {
+                *tuple = build_tuples_[build_row.row];
+                return true;
+            }
+        }
+        // probe with the next row of the partition
+        if (probe_pos_ < probe_bounds_[partition_ + 1]) {
+            probe_hash_ = probe_rows_[probe_pos_++].hash;
+            chain_ = bucket_heads_[probe_hash_ & bucket_mask_];
+            continue;
+        }
+        // move on to the next partition
+        partition_++;
+        if (partition_ < num_partitions) {
+            probe_pos_ = probe_bounds_[partition_];
+            buildPartition();
+        }
+    }
+    return false;
+}
+
+template <typename Row>
+void RadixHashJoinExecutor::partition(std::vector<Row> *rows, std::vector<size_t> *bounds) const {
+    const size_t fanout = (size_t)1 << bits_;
+    bounds->assign(fanout + 1, 0);
+    if (bits_ == 0) {
+        (*bounds)[1] = rows->size();
+        return;
+    }
+    std::vector<Row> scratch(rows->size());
+    std::vector<size_t> counts(fanout, 0);
+    if (num_passes_ == 1) {
+        scatter(rows->data(), rows->size(), scratch.data(), 32 - bits_, bits_, &counts);
+        scratch.swap(*rows);
+    } else {
+        // first pass on the high half of the radix bits, then each of those
+        // partitions again on the low half
+        const int high_bits = (bits_ + 1) / 2, low_bits = bits_ - high_bits;
+        const size_t low_fanout = (size_t)1 << low_bits;
+        std::vector<size_t> high_counts((size_t)1 << high_bits, 0), low_counts(low_fanout, 0);
+        scatter(rows->data(), rows->size(), scratch.data(), 32 - high_bits, high_bits, &high_counts);
+        size_t begin = 0;
+        for (size_t high = 0; high < high_counts.size(); high++) {
+            scatter(scratch.data() + begin, high_counts[high], rows->data() + begin, 32 - bits_, low_bits,
+                    &low_counts);
+            for (size_t low = 0; low < low_fanout; low++) counts[high * low_fanout + low] = low_counts[low];
+            begin += high_counts[high];
+        }
+    }
+    for (size_t p = 0; p < fanout; p++) {
+        (*bounds)[p + 1] = (*bounds)[p] + counts[p];
+    }
+}
+
+void RadixHashJoinExecutor::buildPartition() {
+    if (partition_ + 1 >= build_bounds_.size()) return;
+    const size_t begin = build_bounds_[partition_], size = build_bounds_[partition_ + 1] - begin;
+    size_t buckets = 1;
+    while (buckets < size) buckets *= 2;
+    bucket_mask_ = buckets - 1;
+    bucket_heads_.assign(buckets, NO_ROW);
+    bucket_next_.resize(size);
+    // insert back to front so every chain lists its rows in child order
+    for (size_t i = size; i-- > 0;) {
+        const size_t bucket = build_rows_[begin + i].hash & bucket_mask_;
+        bucket_next_[i] = bucket_heads_[bucket];
+        bucket_heads_[bucket] = (uint32_t)i;
+    }
+}
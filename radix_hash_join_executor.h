@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "hash_join_executor.h"
+#include "storage.h"
+
+/** Target size of the per-partition hash table of a radix join; a typical L2 cache. */
+static const size_t DEFAULT_RADIX_PARTITION_BYTES = 256 * 1024;
+
+/**
+ * RadixHashJoinExecutor executes an in-memory, cache-conscious hash join.
+ * It produces the same tuples as HashJoinExecutor, grouped by partition.
+ *
+ * Init() hashes both children once and radix-partitions the (hash, row) pairs
+ * on the top hash bits, in one or two counting-sort passes, so each partition
+ * of the build side fits in cache. Next() then builds a small bucket-chained
+ * table per partition and probes it with the matching right partition, so
+ * lookups hit cache instead of missing on one large table. Only the left
+ * tuples are kept; the right side is reduced to its hashes.
+ */
+class RadixHashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new radix hash join executor.
+   * @param left_child_executor the left child, used to build the hash tables
+   * @param right_child_executor the right child, used to probe the hash tables
+   * @param hash_fn the hash function of the join key
+   * @param radix_bits log2 of the number of partitions (at most 16), 0 to pick it
+   *                   so each build partition fits in DEFAULT_RADIX_PARTITION_BYTES
+   * @param num_passes number of partitioning passes, 1 or 2; two passes keep the
+   *                   fan-out of each pass low enough for the TLB at high radix_bits
+   */
+  RadixHashJoinExecutor(AbstractExecutor *left_child_executor,
+                        AbstractExecutor *right_child_executor,
+                        SimpleHashFunction *hash_fn,
+                        int radix_bits = 0,
+                        int num_passes = 1);
+
+  /** Initialize the join, partitioning both children */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from join.
+   * @param tuple the next tuple produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+ private:
+  /** The hash of a left row's join key and the row's position in the left child's output. */
+  struct HashedRow {
+    hash_t hash;
+    uint32_t row;
+  };
+
+  /** The hash of a right row's join key; matches are emitted from the left rows alone. */
+  struct ProbeRow {
+    hash_t hash;
+  };
+
+  /**
+   * Radix-partition rows on the top bits_ hash bits.
+   * @param rows the rows to partition, reordered in place by partition (stable)
+   * @param[out] bounds partition p is rows[bounds[p], bounds[p + 1])
+   */
+  template <typename Row>
+  void partition(std::vector<Row> *rows, std::vector<size_t> *bounds) const;
+
+  /** Build the bucket-chained table over the build rows of partition_. */
+  void buildPartition();
+
+  AbstractExecutor *left_;
+  AbstractExecutor *right_;
+  SimpleHashFunction *hash_fn_;
+  int requested_bits_;
+  int num_passes_;
+  int bits_;  ///< radix bits used by the current Init()
+
+  std::vector<Tuple> build_tuples_;       ///< Left tuples in child order
+  std::vector<HashedRow> build_rows_;     ///< Left rows, partitioned
+  std::vector<ProbeRow> probe_rows_;      ///< Right rows, partitioned
+  std::vector<size_t> build_bounds_;
+  std::vector<size_t> probe_bounds_;
+
+  // Table of the current partition: bucket_heads_ holds the first build row of
+  // each bucket and bucket_next_ the next row of the chain, relative to the
+  // partition start, both in child order
+  std::vector<uint32_t> bucket_heads_;
+  std::vector<uint32_t> bucket_next_;
+  size_t bucket_mask_;
+
+  size_t partition_;   ///< Partition being joined
+  size_t probe_pos_;   ///< Next probe row of the partition
+  uint32_t chain_;     ///< Next build row to check for the current probe row
+  hash_t probe_hash_;  ///< Hash of the current probe row
+};
@@ -1,16 +1,50 @@
 #include "../include/seq_scan_executor.h"
 
-SeqScanExecutor::SeqScanExecutor(Table *table) : table_(table){};
+#include "../include/bloom_filter.h"
+#include "../include/hash_join_executor.h"
+
+SeqScanExecutor::SeqScanExecutor(Table *table)
+    : table_(table), bloom_filter_(NULL), bloom_hash_fn_(NULL){};
 
 void SeqScanExecutor::Init() { iter_ = table_->Begin(); }
 
 bool SeqScanExecutor::Next(Tuple *tuple) {
+  const Tuple *curr_tuple;
+  if (!NextRef(&curr_tuple)) return false;
+  // assign in place so the existing val2 buffer of *tuple is reused
+  *tuple = *curr_tuple;
+  return true;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  std::vector<Tuple>::iterator end = table_->End();
+  for (; iter_ != end && !batch->IsFull(); ++iter_) {
+    if (!passesBloomFilter(*iter_)) continue;
+    *batch->Slot() = *iter_;
+    batch->Commit();
+  }
+  return !batch->IsEmpty();
+}
+
+bool SeqScanExecutor::NextRef(const Tuple **tuple) {
   while (iter_ != table_->End()) {
     const Tuple &curr_tuple = *iter_;
-    *tuple = Tuple(curr_tuple);
     ++iter_;
-    return true;
+    if (passesBloomFilter(curr_tuple)) {
+      *tuple = &curr_tuple;
+      return true;
+    }
   }
-
   return false;
 }
+
+bool SeqScanExecutor::PushDownBloomFilter(const BlockedBloomFilter *filter, SimpleHashFunction *hash_fn) {
+  bloom_filter_ = filter;
+  bloom_hash_fn_ = hash_fn;
+  return true;
+}
+
+bool SeqScanExecutor::passesBloomFilter(const Tuple &tuple) const {
+  return bloom_filter_ == NULL || bloom_filter_->MayContain(bloom_hash_fn_->GetHash(tuple));
+}
@@ -22,7 +22,34 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple) override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param batch the batch to fill with the next tuples of the table
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /**
+   * Yield a pointer to the next tuple in the table without copying it.
+   * @param tuple set to the next tuple of the table
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextRef(const Tuple **tuple) override;
+
+  /**
+   * Skip tuples whose key hash is not in the filter, before they are copied.
+   * @param filter the filter pushed down by a hash join, NULL to remove it
+   * @param hash_fn the hash function of the join key
+   * @return `true`
+   */
+  bool PushDownBloomFilter(const BlockedBloomFilter *filter, SimpleHashFunction *hash_fn) override;
+
  private:
+  /** @return `true` if the tuple passes the pushed down Bloom filter, if any */
+  bool passesBloomFilter(const Tuple &tuple) const;
+
   Table *table_;
   std::vector<Tuple>::iterator iter_;
+  const BlockedBloomFilter *bloom_filter_;
+  SimpleHashFunction *bloom_hash_fn_;
 };
@@ -0,0 +1,174 @@
+#include "../include/sort_executor.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// Runs merged at once, bounded to keep the number of open files reasonable
+const size_t MAX_MERGE_FANOUT = 64;
+
+struct TupleLess {
+    TupleColumn column;
+    bool operator()(const Tuple &left, const Tuple &right) const { return CompareKeys(left, right, column) < 0; }
+};
+
+size_t tupleBytes(const Tuple &tuple) { return sizeof(Tuple) + tuple.val2.capacity(); }
+
+}  // namespace
+
+SortExecutor::SortExecutor(AbstractExecutor *child_executor, const std::string &sort_key,
+                           size_t memory_limit, const std::string &temp_dir)
+    : child_(child_executor),
+      column_(TupleColumn::ID),
+      valid_key_(ParseTupleColumn(sort_key, &column_)),
+      memory_limit_(memory_limit),
+      temp_dir_(temp_dir),
+      buffer_pos_(0),
+      queue_(MergeHeadGreater{column_}),
+      failed_(false) {}
+
+void SortExecutor::Init() {
+    buffer_.clear();
+    buffer_pos_ = 0;
+    runs_.clear();
+    heads_.clear();
+    queue_ = MergeQueue(MergeHeadGreater{column_});
+    failed_ = false;
+    if (!valid_key_) return;
+
+    // Fill the buffer, turning it into a sorted run whenever it is full
+    child_->Init();
+    size_t bytes = 0;
+    const Tuple *tuple;
+    bool can_spill = true;
+    while (child_->NextRef(&tuple)) {
+        buffer_.push_back(*tuple);
+        bytes += tupleBytes(*tuple);
+        if (bytes > memory_limit_ && can_spill) {
+            // after a failed spill the rest of the input is sorted in memory
+            if (spillBuffer()) {
+                bytes = 0;
+            } else {
+                can_spill = false;
+            }
+        }
+    }
+    sortBuffer();
+    if (runs_.empty()) return;
+
+    // Too many runs to merge at once: merge consecutive groups first. A group
+    // that cannot be merged keeps its runs, and once a pass merges nothing the
+    // final merge takes every run at once.
+    while (runs_.size() + 1 > MAX_MERGE_FANOUT) {
+        std::vector<std::unique_ptr<SpillFile>> merged;
+        for (size_t begin = 0; begin < runs_.size(); begin += MAX_MERGE_FANOUT) {
+            const size_t end = std::min(begin + MAX_MERGE_FANOUT, runs_.size());
+            std::unique_ptr<SpillFile> run = mergeRuns(begin, end);
+            if (run) {
+                merged.push_back(std::move(run));
+            } else {
+                for (size_t i = begin; i < end; i++) merged.push_back(std::move(runs_[i]));
+            }
+        }
+        const bool progress = merged.size() < runs_.size();
+        runs_.swap(merged);
+        if (!progress) break;
+    }
+    startMerge();
+}
+
+bool SortExecutor::Next(Tuple *tuple) {
+    if (runs_.empty()) {
+        if (buffer_pos_ == buffer_.size()) return false;
+        *tuple = buffer_[buffer_pos_++];
+        return true;
+    }
+    if (failed_ || queue_.empty()) return false;
+    MergeHead *head = queue_.top();
+    queue_.pop();
+    *tuple = head->tuple;
+    if (advance(head)) queue_.push(head);
+    return true;
+}
+
+void SortExecutor::sortBuffer() {
+    TupleLess less = {column_};
+    std::stable_sort(buffer_.begin(), buffer_.end(), less);
+}
+
+bool SortExecutor::spillBuffer() {
+    std::unique_ptr<SpillFile> run(new SpillFile(temp_dir_));
+    if (!run->IsOpen()) return false;  // keep sorting in memory
+    sortBuffer();
+    for (size_t i = 0; i < buffer_.size(); i++) {
+        if (!run->Append(buffer_[i])) return false;
+    }
+    // flush now, so a write that fails later is not found only once the run is read
+    if (!run->Rewind()) return false;
+    buffer_.clear();
+    runs_.push_back(std::move(run));
+    return true;
+}
+
+std::unique_ptr<SpillFile> SortExecutor::mergeRuns(size_t begin, size_t end) {
+    std::unique_ptr<SpillFile> merged(new SpillFile(temp_dir_));
+    if (!merged->IsOpen()) return std::unique_ptr<SpillFile>();
+    std::vector<MergeHead> heads(end - begin);
+    MergeQueue queue(MergeHeadGreater{column_});
+    size_t num_tuples = 0;
+    for (size_t i = 0; i < heads.size(); i++) {
+        heads[i].source = i;
+        num_tuples += runs_[begin + i]->Size();
+        if (!runs_[begin + i]->Rewind()) return std::unique_ptr<SpillFile>();
+        if (runs_[begin + i]->Read(&heads[i].tuple)) queue.push(&heads[i]);
+    }
+    while (!queue.empty()) {
+        MergeHead *head = queue.top();
+        queue.pop();
+        if (!merged->Append(head->tuple)) return std::unique_ptr<SpillFile>();
+        if (runs_[begin + head->source]->Read(&head->tuple)) queue.push(head);
+    }
+    // every tuple must have been read back and made it to disk before the source runs are dropped
+    if (merged->Size() != num_tuples || !merged->Rewind()) return std::unique_ptr<SpillFile>();
+    for (size_t i = begin; i < end; i++) runs_[i].reset();
+    return merged;
+}
+
+void SortExecutor::startMerge() {
+    // sources are the runs in input order, then the buffer holding the last tuples
+    heads_.resize(runs_.size() + 1);
+    for (size_t i = 0; i < heads_.size(); i++) {
+        heads_[i].source = i;
+        heads_[i].remaining = 0;
+        if (i < runs_.size()) {
+            heads_[i].remaining = runs_[i]->Size();
+            if (!runs_[i]->Rewind()) {
+                fail();
+                return;
+            }
+        }
+        if (advance(&heads_[i])) queue_.push(&heads_[i]);
+    }
+}
+
+bool SortExecutor::advance(MergeHead *head) {
+    if (head->source < runs_.size()) {
+        if (head->remaining == 0) return false;
+        // a run must give back every tuple written to it
+        if (!runs_[head->source]->Read(&head->tuple)) {
+            fail();
+            return false;
+        }
+        head->remaining--;
+        return true;
+    }
+    if (buffer_pos_ == buffer_.size()) return false;
+    head->tuple = buffer_[buffer_pos_++];
+    return true;
+}
+
+void SortExecutor::fail() {
+    std::cout << "ERROR: Could not read back the sorted runs from " << temp_dir_ << std::endl;
+    failed_ = true;
+}
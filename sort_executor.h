@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "spill_file.h"
+#include "storage.h"
+#include "tuple_column.h"
+
+/** Default memory budget of a sort, in bytes. */
+static const size_t DEFAULT_SORT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+/**
+ * The SortExecutor sorts the tuples of its child in ascending order of one
+ * attribute. Tuples with equal keys keep their child order.
+ *
+ * Tuples are buffered up to memory_limit bytes. Input that fits is sorted in
+ * memory; otherwise every full buffer is sorted and written to a spill file as
+ * a sorted run, and Next() produces the output with a k-way merge of the runs
+ * (merging in several passes when there are too many runs to open at once).
+ * If a run cannot be read back in full, an error is printed and the output
+ * ends there instead of silently missing tuples.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param child_executor the child executor producing the tuples to sort
+   * @param sort_key the attribute to sort on, one of {"id","val1","val2"}
+   * @param memory_limit memory budget of the in-memory buffer, in bytes
+   * @param temp_dir directory for the sorted runs
+   */
+  SortExecutor(AbstractExecutor *child_executor, const std::string &sort_key,
+               size_t memory_limit = DEFAULT_SORT_MEMORY_LIMIT,
+               const std::string &temp_dir = DEFAULT_SPILL_DIR);
+
+  /** Initialize the sort, consuming the whole child */
+  void Init() override;
+
+  /**
+   * Yield the next tuple in sorted order.
+   * @param tuple the next tuple produced by the sort
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /** @return `true` for the sort key */
+  bool IsSortedOn(TupleColumn column) const override { return valid_key_ && column == column_; }
+
+ private:
+  /** A source of the merge and its current tuple. */
+  struct MergeHead {
+    Tuple tuple;
+    size_t source;     ///< index of the run (or of the in-memory buffer, last)
+    size_t remaining;  ///< tuples of the run not read yet
+  };
+
+  /** Orders merge heads by key, then by source, so equal keys keep input order. */
+  struct MergeHeadGreater {
+    TupleColumn column;
+    bool operator()(const MergeHead *left, const MergeHead *right) const {
+      const int cmp = CompareKeys(left->tuple, right->tuple, column);
+      return cmp > 0 || (cmp == 0 && left->source > right->source);
+    }
+  };
+
+  typedef std::priority_queue<MergeHead *, std::vector<MergeHead *>, MergeHeadGreater> MergeQueue;
+
+  /** Sort the buffer, stably, on the sort key. */
+  void sortBuffer();
+
+  /**
+   * Write the sorted buffer to a new run and empty it.
+   * @return `false` if the run could not be written, the buffer is then kept
+   */
+  bool spillBuffer();
+
+  /**
+   * Merge runs_[begin, end) into a single new run.
+   * @return the new run, or NULL if it could not be written; the source runs
+   *         are only released on success
+   */
+  std::unique_ptr<SpillFile> mergeRuns(size_t begin, size_t end);
+
+  /** Start the final merge of every run and the in-memory buffer. */
+  void startMerge();
+
+  /** Read the next tuple of a merge source into head, @return `false` if it is exhausted or failed */
+  bool advance(MergeHead *head);
+
+  /** Report that a run could not be read back completely, which ends the output. */
+  void fail();
+
+  AbstractExecutor *child_;
+  TupleColumn column_;
+  bool valid_key_;
+  size_t memory_limit_;
+  std::string temp_dir_;
+
+  std::vector<Tuple> buffer_;                       ///< In-memory tuples, sorted after Init()
+  size_t buffer_pos_;                               ///< Next buffered tuple to produce
+  std::vector<std::unique_ptr<SpillFile>> runs_;    ///< Sorted runs, in input order
+  std::vector<MergeHead> heads_;                    ///< One head per merge source
+  MergeQueue queue_;                                ///< Heads that still have a tuple
+  bool failed_;                                     ///< Whether tuples of a run were lost
+};
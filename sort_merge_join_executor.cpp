@@ -0,0 +1,58 @@
+#include "../include/sort_merge_join_executor.h"
+
+SortMergeJoinExecutor::SortMergeJoinExecutor(AbstractExecutor *left_child_executor,
+                                             AbstractExecutor *right_child_executor,
+                                             const std::string &join_key,
+                                             size_t memory_limit,
+                                             const std::string &temp_dir)
+    : left_(left_child_executor),
+      right_(right_child_executor),
+      column_(TupleColumn::ID),
+      valid_key_(ParseTupleColumn(join_key, &column_)),
+      group_pos_(0),
+      left_has_next_(false) {
+    // only sort the inputs that are not already ordered on the join key
+    if (!left_->IsSortedOn(column_)) {
+        left_sort_.reset(new SortExecutor(left_child_executor, join_key, memory_limit, temp_dir));
+        left_ = left_sort_.get();
+    }
+    if (!right_->IsSortedOn(column_)) {
+        right_sort_.reset(new SortExecutor(right_child_executor, join_key, memory_limit, temp_dir));
+        right_ = right_sort_.get();
+    }
+}
+
+void SortMergeJoinExecutor::Init() {
+    left_group_.clear();
+    group_pos_ = 0;
+    left_has_next_ = false;
+    if (!valid_key_) return;
+    left_->Init();
+    right_->Init();
+    left_has_next_ = left_->Next(&left_next_);
+}
+
+bool SortMergeJoinExecutor::Next(Tuple *tuple) {
+    if (!valid_key_) return false;
+    for (;;) {
+        // replay the left group for the current outer tuple
+        if (group_pos_ < left_group_.size()) {
+            *tuple = left_group_[group_pos_++];
+            return true;
+        }
+        if (!right_->Next(&right_tuple_)) return false;
+        group_pos_ = 0;
+        // an outer tuple with the same key as the previous one joins the same group
+        if (!left_group_.empty() && KeysEqual(left_group_[0], right_tuple_, column_)) continue;
+
+        // skip the left tuples with smaller keys, then collect the ones with an equal key
+        left_group_.clear();
+        while (left_has_next_ && CompareKeys(left_next_, right_tuple_, column_) < 0) {
+            left_has_next_ = left_->Next(&left_next_);
+        }
+        while (left_has_next_ && KeysEqual(left_next_, right_tuple_, column_)) {
+            left_group_.push_back(left_next_);
+            left_has_next_ = left_->Next(&left_next_);
+        }
+    }
+}
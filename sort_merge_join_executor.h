@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstract_executor.h"
+#include "sort_executor.h"
+#include "storage.h"
+#include "tuple_column.h"
+
+/**
+ * SortMergeJoinExecutor executes an equi-join by merging its two children in
+ * order of the join key. It produces the same tuples as NestedLoopJoinExecutor
+ * (every inner (left) tuple once per matching outer (right) tuple), ordered by
+ * the join key instead of by outer tuple.
+ *
+ * A child that is not already sorted on the join key (see
+ * AbstractExecutor::IsSortedOn) is wrapped in a SortExecutor, which falls back
+ * to an external merge sort when the child exceeds the memory budget. The left
+ * tuples of the current key are buffered and replayed for each right tuple
+ * with the same key.
+ */
+class SortMergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort-merge join executor.
+   * @param left_child_executor the left child executor (inner table)
+   * @param right_child_executor the right child executor (outer table)
+   * @param join_key the attribute to join on, one of {"id","val1","val2"}
+   * @param memory_limit memory budget of each sort, in bytes
+   * @param temp_dir directory for the sorted runs
+   */
+  SortMergeJoinExecutor(AbstractExecutor *left_child_executor,
+                        AbstractExecutor *right_child_executor,
+                        const std::string &join_key,
+                        size_t memory_limit = DEFAULT_SORT_MEMORY_LIMIT,
+                        const std::string &temp_dir = DEFAULT_SPILL_DIR);
+
+  /** Initialize the join, sorting the children that need it */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from join.
+   * @param tuple the next inner tuple that matches an outer tuple
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple) override;
+
+  /** @return `true` for the join key, the output is produced in key order */
+  bool IsSortedOn(TupleColumn column) const override { return valid_key_ && column == column_; }
+
+ private:
+  AbstractExecutor *left_;                  ///< Sorted left input, left_sort_ or the child itself.
+  AbstractExecutor *right_;                 ///< Sorted right input, right_sort_ or the child itself.
+  std::unique_ptr<SortExecutor> left_sort_;
+  std::unique_ptr<SortExecutor> right_sort_;
+  TupleColumn column_;
+  bool valid_key_;
+
+  std::vector<Tuple> left_group_;  ///< Left tuples sharing the key of right_tuple_
+  size_t group_pos_;               ///< Next tuple of left_group_ to produce
+  Tuple left_next_;                ///< First left tuple after left_group_
+  bool left_has_next_;             ///< Whether left_next_ holds a tuple
+  Tuple right_tuple_;              ///< Current outer tuple
+};
@@ -0,0 +1,56 @@
+#include "../include/spill_file.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+SpillFile::SpillFile(const std::string &temp_dir) : file_(NULL), num_tuples_(0) {
+    std::string path = temp_dir + "/dbms_spill_XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int fd = mkstemp(name.data());
+    if (fd < 0) {
+        std::cout << "ERROR: Could not create spill file in " << temp_dir << std::endl;
+        return;
+    }
+    // unlink right away, the data lives as long as the descriptor is open
+    unlink(name.data());
+    file_ = fdopen(fd, "w+b");
+    if (file_ == NULL) {
+        close(fd);
+        std::cout << "ERROR: Could not open spill file in " << temp_dir << std::endl;
+    }
+}
+
+SpillFile::~SpillFile() {
+    if (file_ != NULL) std::fclose(file_);
+}
+
+// Record layout: id, val1, length of val2, bytes of val2
+bool SpillFile::Append(const Tuple &tuple) {
+    if (file_ == NULL) return false;
+    int32_t header[3] = {tuple.id, tuple.val1, (int32_t)tuple.val2.size()};
+    if (std::fwrite(header, sizeof(header), 1, file_) != 1) return false;
+    if (!tuple.val2.empty() && std::fwrite(tuple.val2.data(), tuple.val2.size(), 1, file_) != 1) return false;
+    num_tuples_++;
+    return true;
+}
+
+bool SpillFile::Rewind() {
+    if (file_ == NULL) return false;
+    return std::fflush(file_) == 0 && std::fseek(file_, 0, SEEK_SET) == 0;
+}
+
+bool SpillFile::Read(Tuple *tuple) {
+    if (file_ == NULL) return false;
+    int32_t header[3];
+    if (std::fread(header, sizeof(header), 1, file_) != 1) return false;
+    tuple->id = header[0];
+    tuple->val1 = header[1];
+    tuple->val2.resize(header[2]);
+    if (header[2] > 0 && std::fread(&tuple->val2[0], header[2], 1, file_) != 1) return false;
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "storage.h"
+
+/** Default directory for the temporary files of spilling operators. */
+static const char *const DEFAULT_SPILL_DIR = "/tmp";
+
+/**
+ * A temporary file of tuples used by operators that spill to disk.
+ * The file is created in a configurable directory and unlinked as soon as it
+ * is opened, so it disappears when the SpillFile is destroyed or the process
+ * exits. Tuples are appended first, then read back after Rewind().
+ */
+class SpillFile {
+ public:
+  /**
+   * Creates a new, empty spill file.
+   * @param temp_dir directory to create the file in
+   */
+  explicit SpillFile(const std::string &temp_dir = DEFAULT_SPILL_DIR);
+  ~SpillFile();
+
+  /** @return `true` if the file could be created */
+  bool IsOpen() const { return file_ != NULL; }
+
+  /** @return the number of tuples appended to the file */
+  size_t Size() const { return num_tuples_; }
+
+  /**
+   * Append a tuple at the end of the file.
+   * @return `true` if the tuple was written
+   */
+  bool Append(const Tuple &tuple);
+
+  /**
+   * Go back to the start of the file to read the tuples in append order.
+   * @return `true` on success
+   */
+  bool Rewind();
+
+  /**
+   * Read the next tuple after Rewind().
+   * @param[out] tuple the next tuple of the file
+   * @return `true` if a tuple was read, `false` at the end of the file
+   */
+  bool Read(Tuple *tuple);
+
+ private:
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  std::FILE *file_;
+  size_t num_tuples_;
+};
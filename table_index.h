@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree.h"
+#include "storage.h"
+
+/**
+ * Helpers tying a BPlusTree to the mocked Table. The table is a single page,
+ * so a RecordPointer into it has page_id 0 and the row number as record_id.
+ */
+
+/** @return the number of tuples in table */
+inline size_t TableSize(Table *table) { return table->End() - table->Begin(); }
+
+/**
+ * Resolve a record pointer returned by the index to its tuple.
+ * @param table the indexed table
+ * @param pointer the record pointer
+ * @return the tuple, or NULL if the pointer is outside the table
+ */
+inline Tuple *ResolveRecordPointer(Table *table, const RecordPointer &pointer) {
+  if (pointer.page_id != 0 || pointer.record_id < 0 ||
+      static_cast<size_t>(pointer.record_id) >= TableSize(table)) {
+    return NULL;
+  }
+  return &*(table->Begin() + pointer.record_id);
+}
+
+/** Marks the last row of a chain of rows sharing an id. */
+static const int NO_NEXT_ROW = -1;
+
+/**
+ * Index of a table on "id". The BPlusTree only holds unique keys, so it maps
+ * every id to the first row holding it, and next_row links each row to the
+ * next row with the same id, in table order. A lookup follows that chain, so
+ * no row with a duplicated id is left out.
+ */
+struct TableIndex {
+  BPlusTree tree;
+  std::vector<int> next_row;  ///< Next row with the same id, or NO_NEXT_ROW
+};
+
+/**
+ * Index every tuple of table on "id". The rows are sorted by id, which chains
+ * the rows of each id, and the first row of every id is bulk loaded.
+ * @param table the table to index
+ * @param index an empty index to build
+ * @param fill_factor share of each node filled when bulk loading
+ * @return the number of tuples indexed, 0 if the index was not empty
+ */
+inline size_t BuildTableIndex(Table *table, TableIndex *index, double fill_factor = DEFAULT_FILL_FACTOR) {
+  if (!index->tree.IsEmpty()) {
+    std::cout << "ERROR: The table index is already built" << std::endl;
+    return 0;
+  }
+  size_t num_rows = TableSize(table);
+  std::vector<std::pair<KeyType, int>> rows;
+  rows.reserve(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    rows.push_back(std::make_pair((table->Begin() + row)->id, static_cast<int>(row)));
+  }
+  // rows of the same id stay in table order
+  std::sort(rows.begin(), rows.end());
+
+  index->next_row.assign(num_rows, NO_NEXT_ROW);
+  std::vector<std::pair<KeyType, RecordPointer>> entries;
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (i > 0 && rows[i].first == rows[i - 1].first) {
+      index->next_row[rows[i - 1].second] = rows[i].second;
+    } else {
+      entries.push_back(std::make_pair(rows[i].first, RecordPointer(0, rows[i].second)));
+    }
+  }
+  index->tree.BulkLoad(entries, fill_factor);
+  return num_rows;
+}
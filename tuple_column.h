@@ -0,0 +1,78 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "storage.h"
+
+/**
+ * An attribute of the Tuple class. Executors that take a key name such as
+ * "id", "val1" or "val2" resolve it once to a TupleColumn instead of
+ * comparing strings for every tuple.
+ */
+enum class TupleColumn { ID, VAL1, VAL2 };
+
+/**
+ * Resolve an attribute name to a column.
+ * @param name one of {"id","val1","val2"}
+ * @param[out] column the resolved column
+ * @return `true` if name is a valid attribute, `false` otherwise
+ */
+inline bool ParseTupleColumn(const std::string &name, TupleColumn *column) {
+  if (name == "id") {
+    *column = TupleColumn::ID;
+  } else if (name == "val1") {
+    *column = TupleColumn::VAL1;
+  } else if (name == "val2") {
+    *column = TupleColumn::VAL2;
+  } else {
+    std::cout << "ERROR: Wrong Type For Key: " << name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/** @return `true` if the two tuples have the same value in column */
+inline bool KeysEqual(const Tuple &left, const Tuple &right, TupleColumn column) {
+  switch (column) {
+    case TupleColumn::ID:
+      return left.id == right.id;
+    case TupleColumn::VAL1:
+      return left.val1 == right.val1;
+    case TupleColumn::VAL2:
+      return left.val2 == right.val2;
+    default:
+      return false;
+  }
+}
+
+/** @return a negative number, zero or a positive number if left's value in column is smaller, equal or greater */
+inline int CompareKeys(const Tuple &left, const Tuple &right, TupleColumn column) {
+  switch (column) {
+    case TupleColumn::ID:
+      return left.id < right.id ? -1 : (left.id > right.id ? 1 : 0);
+    case TupleColumn::VAL1:
+      return left.val1 < right.val1 ? -1 : (left.val1 > right.val1 ? 1 : 0);
+    case TupleColumn::VAL2:
+      return left.val2.compare(right.val2);
+    default:
+      return 0;
+  }
+}
+
+/** Copy the value of column from one tuple to another. */
+inline void CopyKey(const Tuple &from, Tuple *to, TupleColumn column) {
+  switch (column) {
+    case TupleColumn::ID:
+      to->id = from.id;
+      break;
+    case TupleColumn::VAL1:
+      to->val1 = from.val1;
+      break;
+    case TupleColumn::VAL2:
+      to->val2 = from.val2;
+      break;
+    default:
+      break;
+  }
+}